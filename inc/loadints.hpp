@@ -1,36 +1,303 @@
 #ifndef LOADINTS_INCLUDED
 #define LOADINTS_INCLUDED
 
+#include "mappedfile.hpp"
+#include "timescope.hpp"
+
 #include <vector>
 #include <string>
+#include <string_view>
+#include <limits>
+#include <cstring>
+#include <cstdint>
 #include <fstream>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+struct ParseError
+{
+  size_t offset = 0;
+  std::string message;
+};
+
+
+inline bool IsDigit(char const c)
+{
+  return static_cast<unsigned char>(c - '0') < 10;
+}
 
 
-inline std::vector<int> LoadIntsFromStream(std::istream& is)
+inline bool IsWhitespace(char const c)
 {
-  int my_int;
-  std::vector<int> ints;
+  return c == ' ' || static_cast<unsigned char>(c - '\t') < 5;
+}
+
+
+#if defined(__AVX2__)
+inline uint32_t NonDigitMask(char const* const p)
+{
+  __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+  __m256i const biased = _mm256_xor_si256(_mm256_sub_epi8(block, _mm256_set1_epi8('0')), _mm256_set1_epi8(-128));
+  return _mm256_movemask_epi8(_mm256_cmpgt_epi8(biased, _mm256_set1_epi8(-128 + 9)));
+}
 
-  while (is >> my_int)
+inline uint32_t NonWhitespaceMask(char const* const p)
+{
+  __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+  __m256i const biased = _mm256_xor_si256(_mm256_sub_epi8(block, _mm256_set1_epi8('\t')), _mm256_set1_epi8(-128));
+  __m256i const control = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 5), biased);
+  __m256i const space = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+  return ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(control, space)));
+}
+
+size_t const SCAN_WIDTH = 32;
+#elif defined(__SSE2__)
+inline uint32_t NonDigitMask(char const* const p)
+{
+  __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+  __m128i const biased = _mm_xor_si128(_mm_sub_epi8(block, _mm_set1_epi8('0')), _mm_set1_epi8(-128));
+  return _mm_movemask_epi8(_mm_cmpgt_epi8(biased, _mm_set1_epi8(-128 + 9)));
+}
+
+inline uint32_t NonWhitespaceMask(char const* const p)
+{
+  __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+  __m128i const biased = _mm_xor_si128(_mm_sub_epi8(block, _mm_set1_epi8('\t')), _mm_set1_epi8(-128));
+  __m128i const control = _mm_cmplt_epi8(biased, _mm_set1_epi8(-128 + 5));
+  __m128i const space = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+  return ~_mm_movemask_epi8(_mm_or_si128(control, space)) & 0xffff;
+}
+
+size_t const SCAN_WIDTH = 16;
+#else
+inline uint32_t NonDigitMask(char const* const p)
+{
+  uint32_t mask = 0;
+
+  for (unsigned i = 0; i < 8; i++)
   {
-    ints.push_back(my_int);
+    mask |= IsDigit(p[i]) ? 0 : (1u << i);
   }
 
-  return ints;
+  return mask;
+}
+
+inline uint32_t NonWhitespaceMask(char const* const p)
+{
+  uint32_t mask = 0;
+
+  for (unsigned i = 0; i < 8; i++)
+  {
+    mask |= IsWhitespace(p[i]) ? 0 : (1u << i);
+  }
+
+  return mask;
+}
+
+size_t const SCAN_WIDTH = 8;
+#endif
+
+
+// Position of the first non-digit at or after i
+inline size_t SkipDigits(char const* const data, size_t const size, size_t i)
+{
+  for (; i + SCAN_WIDTH <= size; i += SCAN_WIDTH)
+  {
+    uint32_t const mask = NonDigitMask(data + i);
+
+    if (mask != 0)
+    {
+      return i + __builtin_ctz(mask);
+    }
+  }
+
+  while (i < size && IsDigit(data[i]))
+  {
+    i++;
+  }
+
+  return i;
+}
+
+
+// Position of the first non-whitespace character at or after i
+inline size_t SkipWhitespace(char const* const data, size_t const size, size_t i)
+{
+  for (; i + SCAN_WIDTH <= size; i += SCAN_WIDTH)
+  {
+    uint32_t const mask = NonWhitespaceMask(data + i);
+
+    if (mask != 0)
+    {
+      return i + __builtin_ctz(mask);
+    }
+  }
+
+  while (i < size && IsWhitespace(data[i]))
+  {
+    i++;
+  }
+
+  return i;
+}
+
+
+// Value of exactly 8 decimal digits, combined pairwise in one register
+inline uint64_t ParseEightDigits(char const* const p)
+{
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+
+  v -= 0x3030303030303030;
+  v = (v * 10) + (v >> 8);
+  v = (((v & 0x000000ff000000ff) * (100 + (1000000ULL << 32))) +
+       (((v >> 16) & 0x000000ff000000ff) * (1 + (10000ULL << 32)))) >> 32;
+
+  return v;
+}
+
+
+// Value of a run of digits, false if it does not fit in 64 bits
+inline bool ParseDigits(char const* p, size_t length, uint64_t& value)
+{
+  value = 0;
+
+  // Leading zeros can make a long run with a small value
+  while (length > 1 && *p == '0')
+  {
+    p++;
+    length--;
+  }
+
+  if (length > 20)
+  {
+    return false;
+  }
+
+  while (length >= 8)
+  {
+    if (__builtin_mul_overflow(value, 100000000, &value) ||
+        __builtin_add_overflow(value, ParseEightDigits(p), &value))
+    {
+      return false;
+    }
+
+    p += 8;
+    length -= 8;
+  }
+
+  for (; length > 0; p++, length--)
+  {
+    if (__builtin_mul_overflow(value, 10, &value) ||
+        __builtin_add_overflow(value, static_cast<uint64_t>(*p - '0'), &value))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+// Parses whitespace separated decimal integers from a buffer.
+// On failure, error holds the byte offset of the offending token.
+template<class T>
+inline bool ParseInts(std::string_view const buffer, std::vector<T>& ints, ParseError& error)
+{
+  static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(uint64_t), "ParseInts needs an integer type");
+
+  char const* const data = buffer.data();
+  size_t const size = buffer.size();
+
+  uint64_t const max_positive = std::numeric_limits<T>::max();
+  uint64_t const max_negative = std::is_signed<T>::value ? max_positive + 1 : 0;
+
+  size_t i = SkipWhitespace(data, size, 0);
+
+  while (i < size)
+  {
+    size_t const start = i;
+    bool negative = false;
+
+    if (data[i] == '-' || data[i] == '+')
+    {
+      negative = data[i] == '-';
+      i++;
+    }
+
+    size_t const end = SkipDigits(data, size, i);
+
+    if (end == i)
+    {
+      error.offset = i;
+      error.message = (i < size) ?
+        std::string("Unexpected character '") + data[i] + "'" :
+        std::string("Expected digits at end of input");
+      return false;
+    }
+
+    if (end < size && !IsWhitespace(data[end]))
+    {
+      error.offset = end;
+      error.message = std::string("Unexpected character '") + data[end] + "'";
+      return false;
+    }
+
+    uint64_t magnitude;
+
+    if (!ParseDigits(data + i, end - i, magnitude) ||
+        magnitude > (negative ? max_negative : max_positive))
+    {
+      error.offset = start;
+      error.message = "Integer out of range";
+      return false;
+    }
+
+    ints.push_back(negative ? static_cast<T>(0 - magnitude) : static_cast<T>(magnitude));
+
+    i = SkipWhitespace(data, size, end);
+  }
+
+  return true;
 }
 
 
-inline std::vector<int> LoadIntsFromFile(std::string const path)
+template<class T = int>
+inline std::vector<T> LoadIntsFromBuffer(std::string_view const buffer, std::string const& name)
 {
-  std::ifstream ifs(path);
+  std::vector<T> ints;
+  ParseError error;
 
-  if (!ifs)
+  if (!ParseInts(buffer, ints, error))
   {
-    std::cerr << "No such file '" << path << "'" << std::endl;
+    std::cerr << name << ":" << error.offset << ": " << error.message << std::endl;
     exit(1);
   }
 
-  return LoadIntsFromStream(ifs);
+  return ints;
+}
+
+
+template<class T = int>
+inline std::vector<T> LoadIntsFromStream(std::istream& is)
+{
+  std::string const buffer(std::istreambuf_iterator<char>(is), {});
+  return LoadIntsFromBuffer<T>(buffer, "<stream>");
+}
+
+
+template<class T = int>
+inline std::vector<T> LoadIntsFromFile(std::string const path)
+{
+  TimeScope t("LoadIntsFromFile");
+  MappedFile const file(path);
+  return LoadIntsFromBuffer<T>(file.View(), path);
 }
 
 
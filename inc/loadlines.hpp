@@ -1,10 +1,165 @@
 #ifndef LOADLINES_INCLUDED
 #define LOADLINES_INCLUDED
 
+#include "mappedfile.hpp"
+#include "timescope.hpp"
+
 #include <vector>
 #include <string>
+#include <string_view>
+#include <memory>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+// Calls fn(offset) with the offset of every '\n' in the buffer, in order.
+template<class Fn>
+inline void ForEachNewline(std::string_view const buffer, Fn&& fn)
+{
+  char const* const data = buffer.data();
+  size_t const size = buffer.size();
+  size_t i = 0;
+
+#if defined(__AVX2__)
+  __m256i const newline = _mm256_set1_epi8('\n');
+
+  for (; i + 32 <= size; i += 32)
+  {
+    __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + i));
+    uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline));
+
+    while (mask != 0)
+    {
+      fn(i + __builtin_ctz(mask));
+      mask &= mask - 1;
+    }
+  }
+#elif defined(__SSE2__)
+  __m128i const newline = _mm_set1_epi8('\n');
+
+  for (; i + 16 <= size; i += 16)
+  {
+    __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+    uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+
+    while (mask != 0)
+    {
+      fn(i + __builtin_ctz(mask));
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  // Tail (or everything, if there is no vector unit to speak of)
+  while (i < size)
+  {
+    void const* const found = memchr(data + i, '\n', size - i);
+
+    if (found == nullptr)
+    {
+      break;
+    }
+
+    i = static_cast<char const*>(found) - data;
+    fn(i++);
+  }
+}
+
+
+// Calls fn(line) for every line in the buffer, without copying anything.
+// Follows std::getline, so a trailing newline does not produce an empty line.
+template<class Fn>
+inline void ForEachLine(std::string_view const buffer, Fn&& fn)
+{
+  size_t start = 0;
+
+  ForEachNewline(buffer, [&](size_t const end)
+  {
+    fn(buffer.substr(start, end - start));
+    start = end + 1;
+  });
+
+  if (start < buffer.size())
+  {
+    fn(buffer.substr(start));
+  }
+}
+
+
+// Splits the buffer into pieces of about chunk_size bytes, each one ending
+// just after a newline (apart from the last), so that no line is split.
+inline std::vector<std::string_view> SplitIntoChunks(std::string_view const buffer, size_t const chunk_size)
+{
+  std::vector<std::string_view> chunks;
+  size_t start = 0;
+
+  while (start < buffer.size())
+  {
+    size_t end = std::min(start + std::max<size_t>(chunk_size, 1), buffer.size());
+
+    if (end < buffer.size())
+    {
+      void const* const newline = memchr(buffer.data() + end - 1, '\n', buffer.size() - end + 1);
+      end = newline ? static_cast<char const*>(newline) - buffer.data() + 1 : buffer.size();
+    }
+
+    chunks.push_back(buffer.substr(start, end - start));
+    start = end;
+  }
+
+  return chunks;
+}
+
+
+// List of lines which are views into a buffer (usually a mapped file).
+// Costs one allocation for the whole list rather than one per line.
+class LineList
+{
+private:
+  std::shared_ptr<MappedFile const> file;
+  std::vector<std::string_view> lines;
+
+  void Index(std::string_view const buffer)
+  {
+    ForEachLine(buffer, [&](std::string_view const line)
+    {
+      lines.push_back(line);
+    });
+  }
+
+
+public:
+  typedef std::vector<std::string_view>::const_iterator const_iterator;
+
+  // Does not take ownership, buffer must outlive the list
+  LineList(std::string_view const buffer)
+  {
+    Index(buffer);
+  }
+
+  LineList(std::shared_ptr<MappedFile const> file) :
+    file(file)
+  {
+    Index(file->View());
+  }
+
+  const_iterator begin() const { return lines.begin(); }
+  const_iterator end() const { return lines.end(); }
+
+  size_t size() const { return lines.size(); }
+  bool empty() const { return lines.empty(); }
+
+  std::string_view operator[](size_t const i) const { return lines[i]; }
+  std::string_view at(size_t const i) const { return lines.at(i); }
+  std::string_view front() const { return lines.front(); }
+  std::string_view back() const { return lines.back(); }
+};
 
 
 inline std::vector<std::string> LoadLinesFromStream(std::istream& is)
@@ -21,17 +176,10 @@ inline std::vector<std::string> LoadLinesFromStream(std::istream& is)
 }
 
 
-inline std::vector<std::string> LoadLinesFromFile(std::string const path)
+inline LineList LoadLinesFromFile(std::string const& path)
 {
-  std::ifstream ifs(path);
-
-  if (!ifs)
-  {
-    std::cerr << "No such file '" << path << "'" << std::endl;
-    exit(1);
-  }
-
-  return LoadLinesFromStream(ifs);
+  TimeScope t("LoadLinesFromFile");
+  return LineList(std::make_shared<MappedFile const>(path));
 }
 
 
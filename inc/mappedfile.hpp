@@ -0,0 +1,186 @@
+#ifndef MAPPEDFILE_INCLUDED
+#define MAPPEDFILE_INCLUDED
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+// Read-only memory mapping of a whole file.
+// The contents stay valid for as long as the MappedFile is alive.
+// Anything that can't be mapped (a pipe, a FIFO, /dev/stdin, a procfs file
+// whose size reads as zero) is read to the end into a buffer instead.
+class MappedFile
+{
+private:
+  char const* data = nullptr;
+  size_t size = 0;
+  std::vector<char> buffer;  // the contents when they are read, not mapped
+
+  void Release()
+  {
+    if (data != nullptr && buffer.empty())
+    {
+      munmap(const_cast<char*>(data), size);
+    }
+
+    buffer.clear();
+    data = nullptr;
+    size = 0;
+  }
+
+  void ReadAll(int const fd, std::string const& path)
+  {
+    size_t const CHUNK = 1 << 16;
+
+    for (;;)
+    {
+      buffer.resize(size + CHUNK);
+      ssize_t const count = read(fd, buffer.data() + size, CHUNK);
+
+      if (count < 0 && errno == EINTR)
+      {
+        continue;
+      }
+
+      if (count < 0)
+      {
+        std::cerr << "Unable to read '" << path << "'" << std::endl;
+        exit(1);
+      }
+
+      if (count == 0)
+      {
+        break;
+      }
+
+      size += count;
+    }
+
+    buffer.resize(size);
+    data = size > 0 ? buffer.data() : nullptr;
+  }
+
+
+public:
+  MappedFile(std::string const& path)
+  {
+    int const fd = open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+      std::cerr << "No such file '" << path << "'" << std::endl;
+      exit(1);
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) != 0)
+    {
+      std::cerr << "Unable to stat '" << path << "'" << std::endl;
+      exit(1);
+    }
+
+    // procfs and sysfs files say they are empty whatever they hold, so an
+    // empty regular file is read as well, which costs nothing if it is
+    if (!S_ISREG(st.st_mode) || st.st_size == 0)
+    {
+      ReadAll(fd, path);
+      close(fd);
+      return;
+    }
+
+    size = st.st_size;
+
+    void* const mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (mapping == MAP_FAILED)
+    {
+      std::cerr << "Unable to map '" << path << "'" << std::endl;
+      exit(1);
+    }
+
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    data = static_cast<char const*>(mapping);
+
+    close(fd);
+  }
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+
+  MappedFile(MappedFile&& other) :
+    data(other.data), size(other.size), buffer(std::move(other.buffer))
+  {
+    other.buffer.clear();
+    other.data = nullptr;
+    other.size = 0;
+  }
+
+  MappedFile& operator=(MappedFile&& other)
+  {
+    if (this != &other)
+    {
+      Release();
+      data = other.data;
+      size = other.size;
+      buffer = std::move(other.buffer);
+      other.buffer.clear();
+      other.data = nullptr;
+      other.size = 0;
+    }
+
+    return *this;
+  }
+
+  ~MappedFile()
+  {
+    Release();
+  }
+
+  std::string_view View() const
+  {
+    return std::string_view(data, size);
+  }
+};
+
+
+// Maps each file at most once, however many times (or from however many
+// threads) it is asked for. Mappings live as long as the cache or the last
+// shared_ptr to them.
+class MappedFileCache
+{
+private:
+  std::mutex mutex;
+  std::map<std::string, std::shared_ptr<MappedFile const>> files;
+
+
+public:
+  std::shared_ptr<MappedFile const> Get(std::string const& path)
+  {
+    std::lock_guard<std::mutex> const lock(mutex);
+
+    auto& file = files[path];
+
+    if (file == nullptr)
+    {
+      file = std::make_shared<MappedFile const>(path);
+    }
+
+    return file;
+  }
+};
+
+
+#endif // MAPPEDFILE_INCLUDED
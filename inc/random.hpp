@@ -0,0 +1,67 @@
+#ifndef RANDOM_INCLUDED
+#define RANDOM_INCLUDED
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+
+// SplitMix64. The standard library's distributions differ between
+// implementations, so this is what to use when the same seed has to give the
+// same sequence everywhere (e.g. generated puzzle inputs).
+class Random
+{
+private:
+  uint64_t state;
+
+
+public:
+  Random(uint64_t const seed) :
+    state(seed)
+  {}
+
+  uint64_t Next()
+  {
+    uint64_t z = (state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  // Uniform in [0, n), n must be non-zero
+  uint64_t Below(uint64_t const n)
+  {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(Next()) * n) >> 64);
+  }
+
+  // Uniform in [min, max]
+  int64_t Between(int64_t const min, int64_t const max)
+  {
+    return min + static_cast<int64_t>(Below(static_cast<uint64_t>(max - min) + 1));
+  }
+
+  // True with probability numerator / denominator
+  bool Chance(uint64_t const numerator, uint64_t const denominator)
+  {
+    return Below(denominator) < numerator;
+  }
+
+  template<class T>
+  T const& Pick(std::vector<T> const& v)
+  {
+    return v[Below(v.size())];
+  }
+
+  template<class T>
+  void Shuffle(std::vector<T>& v)
+  {
+    for (size_t i = v.size(); i > 1; i--)
+    {
+      std::swap(v[i - 1], v[Below(i)]);
+    }
+  }
+};
+
+
+#endif // RANDOM_INCLUDED
@@ -0,0 +1,20 @@
+#ifndef SOLVER_INCLUDED
+#define SOLVER_INCLUDED
+
+#include <string>
+#include <string_view>
+#include <functional>
+
+
+// A day's solution as a library function, so that it can be driven by
+// something other than its own main (the benchmark harness, for instance).
+// Solve takes the whole puzzle input and returns the answers as text.
+struct Solver
+{
+  std::string name;
+  std::string input;
+  std::function<std::string(std::string_view)> solve;
+};
+
+
+#endif // SOLVER_INCLUDED
@@ -2,54 +2,188 @@
 #define STRINGUTIL_INCLUDED
 
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <charconv>
+#include <iterator>
+#include <utility>
 
 
-std::string const WHITESPACE = " \n\r\t\f\v";
+// All of these return views into the string they are given,
+// so the argument must outlive the result.
 
 
-std::string ltrim(std::string const str)
+std::string_view const WHITESPACE = " \n\r\t\f\v";
+
+
+inline std::string_view ltrim(std::string_view const str)
 {
   size_t start = str.find_first_not_of(WHITESPACE);
-  return (start == std::string::npos) ? "" : str.substr(start);
+  return (start == std::string_view::npos) ? "" : str.substr(start);
 }
 
 
-std::string rtrim(std::string const str)
+inline std::string_view rtrim(std::string_view const str)
 {
   size_t end = str.find_last_not_of(WHITESPACE);
-  return (end == std::string::npos) ? "" : str.substr(0, end + 1);
+  return (end == std::string_view::npos) ? "" : str.substr(0, end + 1);
 }
 
 
-std::string trim(std::string const str)
+inline std::string_view trim(std::string_view const str)
 {
   return rtrim(ltrim(str));
 }
 
 
-int StringToInt(std::string const str)
+// Like stream extraction, leading whitespace is skipped and parsing stops
+// at the first character which isn't part of the number. Returns 0 on failure.
+template<class T = int>
+inline T StringToInt(std::string_view str)
 {
-  std::stringstream ss(str);
-  int i;
-  ss >> i;
+  str = ltrim(str);
+
+  if (str.size() > 1 && str[0] == '+')
+  {
+    str.remove_prefix(1);
+  }
+
+  T i = 0;
+  std::from_chars(str.data(), str.data() + str.size(), i);
   return i;
 }
 
 
-std::vector<std::string> Split(std::string const str, char const delim)
+// Lazy split, produces the same tokens as repeated std::getline(ss, token, delim)
+class SplitRange
+{
+private:
+  std::string_view str;
+  char delim;
+
+
+public:
+  class iterator
+  {
+  private:
+    std::string_view str;
+    char delim = 0;
+    size_t start = 0;
+    size_t end = 0;
+
+    void Find()
+    {
+      end = str.find(delim, start);
+
+      if (end == std::string_view::npos)
+      {
+        end = str.size();
+      }
+    }
+
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef std::string_view value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::string_view const* pointer;
+    typedef std::string_view reference;
+
+    iterator()
+    {}
+
+    iterator(std::string_view const str, char const delim, size_t const start) :
+      str(str), delim(delim), start(start)
+    {
+      if (start < str.size())
+      {
+        Find();
+      }
+    }
+
+    std::string_view operator*() const
+    {
+      return str.substr(start, end - start);
+    }
+
+    iterator& operator++()
+    {
+      start = end + 1;
+
+      // Nothing after the final delimiter means no more tokens
+      if (start >= str.size())
+      {
+        start = str.size();
+      }
+      else
+      {
+        Find();
+      }
+
+      return *this;
+    }
+
+    iterator operator++(int)
+    {
+      iterator const previous = *this;
+      ++(*this);
+      return previous;
+    }
+
+    bool operator==(iterator const& other) const
+    {
+      return start == other.start;
+    }
+
+    bool operator!=(iterator const& other) const
+    {
+      return start != other.start;
+    }
+  };
+
+  SplitRange(std::string_view const str, char const delim) :
+    str(str), delim(delim)
+  {}
+
+  iterator begin() const
+  {
+    return iterator(str, delim, 0);
+  }
+
+  iterator end() const
+  {
+    return iterator(str, delim, str.size());
+  }
+};
+
+
+inline SplitRange Split(std::string_view const str, char const delim)
 {
-  std::stringstream ss(str);
-  std::vector<std::string> tokens;
+  return SplitRange(str, delim);
+}
 
-  std::string token;
 
-  while (std::getline(ss, token, delim))
+// Splits around the first occurrence of the delimiter.
+// If there isn't one, the whole string is returned as the first half.
+inline std::pair<std::string_view, std::string_view> SplitOnce(
+  std::string_view const str,
+  std::string_view const delim)
+{
+  size_t const pos = str.find(delim);
+
+  if (pos == std::string_view::npos)
   {
-    tokens.push_back(token);
+    return std::make_pair(str, std::string_view());
   }
 
-  return tokens;
+  return std::make_pair(str.substr(0, pos), str.substr(pos + delim.size()));
+}
+
+
+inline std::pair<std::string_view, std::string_view> SplitOnce(
+  std::string_view const str,
+  char const delim)
+{
+  return SplitOnce(str, std::string_view(&delim, 1));
 }
 
 
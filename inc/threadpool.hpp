@@ -0,0 +1,133 @@
+#ifndef THREADPOOL_INCLUDED
+#define THREADPOOL_INCLUDED
+
+#include <queue>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <future>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+
+// Fixed set of worker threads taking tasks from a shared queue, one per core
+// unless told otherwise (0 also means one per core), and never more than
+// MAX_THREADS. Tasks still queued when the pool is destroyed are run before
+// the workers exit.
+class ThreadPool
+{
+public:
+  static constexpr unsigned MAX_THREADS = 1024;
+
+
+private:
+  std::vector<std::thread> workers;
+  std::queue<std::function<void()>> tasks;
+
+  std::mutex mutex;
+  std::condition_variable available;
+  bool stopping = false;
+
+
+  void Work()
+  {
+    while (true)
+    {
+      std::function<void()> task;
+
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+        if (tasks.empty())
+        {
+          return;
+        }
+
+        task = std::move(tasks.front());
+        tasks.pop();
+      }
+
+      task();
+    }
+  }
+
+
+public:
+  ThreadPool(unsigned thread_count = std::thread::hardware_concurrency())
+  {
+    if (thread_count == 0)
+    {
+      thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    thread_count = std::min(thread_count, MAX_THREADS);
+
+    for (unsigned i = 0; i < thread_count; i++)
+    {
+      workers.emplace_back([this] { Work(); });
+    }
+  }
+
+  ThreadPool(ThreadPool const&) = delete;
+  ThreadPool& operator=(ThreadPool const&) = delete;
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> const lock(mutex);
+      stopping = true;
+    }
+
+    available.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+      worker.join();
+    }
+  }
+
+  size_t Size() const
+  {
+    return workers.size();
+  }
+
+  template<class Fn>
+  std::future<std::invoke_result_t<Fn>> Submit(Fn&& fn)
+  {
+    // std::function needs something copyable, a packaged_task is not
+    auto const task = std::make_shared<std::packaged_task<std::invoke_result_t<Fn>()>>(std::forward<Fn>(fn));
+    auto result = task->get_future();
+
+    {
+      std::lock_guard<std::mutex> const lock(mutex);
+      tasks.push([task] { (*task)(); });
+    }
+
+    available.notify_one();
+
+    return result;
+  }
+};
+
+
+// A thread count given on the command line, 0 for one per core. Stops with
+// an error if it is negative or more than the pool will run.
+inline unsigned ThreadCount(long const threads)
+{
+  if (threads < 0 || threads > static_cast<long>(ThreadPool::MAX_THREADS))
+  {
+    std::cerr << "threads must be between 0 and " << ThreadPool::MAX_THREADS << std::endl;
+    exit(1);
+  }
+
+  return threads;
+}
+
+
+#endif // THREADPOOL_INCLUDED
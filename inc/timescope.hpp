@@ -2,31 +2,595 @@
 #define TIMESCOPE_INCLUDED
 
 #include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
 #include <iostream>
+#include <fstream>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
-class TimeScope
+
+// Hierarchical scope profiler.
+//
+// Every TimeScope records into a per-thread tree of named scopes, so nested
+// scopes are reported under their parents. Statistics are kept per path and
+// merged across threads when the process exits. Reporting is off unless asked
+// for with environment variables:
+//
+//   TIMESCOPE_REPORT  comma separated list of text, json, trace (default: none)
+//   TIMESCOPE_OUTPUT  file name prefix for the json and trace reports
+//                     (default: timescope), text always goes to stderr
+//
+// With no report, scopes only keep track of where they are in the tree, and
+// individual events are only kept for a trace report. When a thread exits,
+// its profile is folded into what is kept for the report and freed, so
+// short lived threads (a pool per call) don't add up.
+
+
+// Raw timestamps. Uses the TSC where there is one, and converts to seconds
+// using the steady clock interval covered by the profile.
+class ProfileClock
 {
 private:
+  uint64_t const tick_origin;
+  std::chrono::steady_clock::time_point const time_origin;
+
+
+public:
+  ProfileClock() :
+    tick_origin(Now()),
+    time_origin(std::chrono::steady_clock::now())
+  {}
+
+  static uint64_t Now()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+  }
+
+  uint64_t Origin() const
+  {
+    return tick_origin;
+  }
+
+  double SecondsPerTick() const
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t const ticks = Now() - tick_origin;
+    std::chrono::duration<double> const seconds = std::chrono::steady_clock::now() - time_origin;
+    return ticks > 0 ? seconds.count() / ticks : 0;
+#else
+    return std::chrono::duration<double>(std::chrono::steady_clock::duration(1)).count();
+#endif
+  }
+};
+
+
+// One node in a thread's scope tree
+struct ProfileNode
+{
+  static size_t const MAX_SAMPLES = 1 << 16;
+
   std::string const name;
+  ProfileNode* const parent;
+  std::vector<std::unique_ptr<ProfileNode>> children;
 
-  std::chrono::high_resolution_clock::time_point t_start;
-  std::chrono::high_resolution_clock::time_point t_end;
+  uint64_t count = 0;
+  uint64_t total = 0;
+  uint64_t min = UINT64_MAX;
+  uint64_t max = 0;
 
+  // Bounded reservoir of durations for percentiles
+  std::vector<uint64_t> samples;
+  uint64_t random_state = 0x9e3779b97f4a7c15;
 
+  ProfileNode(std::string_view const name, ProfileNode* const parent) :
+    name(name), parent(parent)
+  {}
 
+  ProfileNode* Child(std::string_view const child_name)
+  {
+    for (auto const& child : children)
+    {
+      if (child->name == child_name)
+      {
+        return child.get();
+      }
+    }
 
-public:
-  TimeScope(std::string const name) :
-    name(name),
-    t_start(std::chrono::high_resolution_clock::now())
+    children.push_back(std::make_unique<ProfileNode>(child_name, this));
+    return children.back().get();
+  }
+
+  void Record(uint64_t const duration)
+  {
+    count++;
+    total += duration;
+    min = std::min(min, duration);
+    max = std::max(max, duration);
+
+    if (samples.size() < MAX_SAMPLES)
+    {
+      samples.push_back(duration);
+    }
+    else
+    {
+      random_state ^= random_state << 13;
+      random_state ^= random_state >> 7;
+      random_state ^= random_state << 17;
+
+      uint64_t const slot = random_state % count;
+
+      if (slot < MAX_SAMPLES)
+      {
+        samples[slot] = duration;
+      }
+    }
+  }
+};
+
+
+struct ProfileEvent
+{
+  ProfileNode const* node;
+  uint64_t start;
+  uint64_t end;
+};
+
+
+struct ThreadProfile
+{
+  static size_t const MAX_EVENTS = 1 << 20;
+
+  unsigned const id;
+  bool const record_stats;
+  bool const record_events;
+
+  ProfileNode root;
+  ProfileNode* current;
+
+  std::vector<ProfileEvent> events;
+  uint64_t dropped_events = 0;
+
+  ThreadProfile(unsigned const id, bool const record_stats, bool const record_events) :
+    id(id), record_stats(record_stats), record_events(record_events), root("", nullptr), current(&root)
   {}
+};
+
+
+class Profiler
+{
+private:
+  ProfileClock clock;
+
+  bool const report_text;
+  bool const report_json;
+  bool const report_trace;
+  std::string const output;
+
+  std::mutex mutex;
+  std::vector<ThreadProfile const*> threads;  // those still running
+  unsigned thread_count = 0;
+
+
+  // Same shape as a ProfileNode, but merged across threads
+  struct Summary
+  {
+    std::string name;
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+    std::vector<uint64_t> samples;
+    std::vector<Summary> children;
+
+    Summary& Child(std::string const& child_name)
+    {
+      for (Summary& child : children)
+      {
+        if (child.name == child_name)
+        {
+          return child;
+        }
+      }
+
+      children.push_back(Summary());
+      children.back().name = child_name;
+      return children.back();
+    }
+
+    void Merge(ProfileNode const& node)
+    {
+      count += node.count;
+      total += node.total;
+      min = std::min(min, node.min);
+      max = std::max(max, node.max);
+      samples.insert(samples.end(), node.samples.begin(), node.samples.end());
+
+      for (auto const& child : node.children)
+      {
+        Child(child->name).Merge(*child);
+      }
+    }
+
+    // Keeps a random MAX_SAMPLES of the samples, all the way down, so that
+    // merging in thread after thread doesn't grow them without end
+    void Bound(uint64_t& random_state)
+    {
+      size_t const keep = ProfileNode::MAX_SAMPLES;
+
+      if (samples.size() > keep)
+      {
+        for (size_t i = 0; i < keep; i++)
+        {
+          random_state ^= random_state << 13;
+          random_state ^= random_state >> 7;
+          random_state ^= random_state << 17;
+
+          std::swap(samples[i], samples[i + random_state % (samples.size() - i)]);
+        }
+
+        samples.resize(keep);
+      }
+
+      for (Summary& child : children)
+      {
+        child.Bound(random_state);
+      }
+    }
+
+    uint64_t Percentile(double const p)
+    {
+      if (samples.empty())
+      {
+        return 0;
+      }
+
+      size_t const i = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+      std::nth_element(samples.begin(), samples.begin() + i, samples.end());
+      return samples[i];
+    }
+  };
+
+
+  // An event from a thread which has exited, named from exited_names
+  struct ExitedEvent
+  {
+    std::string const* name;
+    unsigned thread;
+    uint64_t start;
+    uint64_t end;
+  };
+
+  // What is kept of the threads which have exited
+  Summary exited;
+  std::set<std::string> exited_names;
+  std::vector<ExitedEvent> exited_events;
+  uint64_t exited_dropped_events = 0;
+  uint64_t random_state = 0x9e3779b97f4a7c15;
+
+
+  // Frees a thread's profile, keeping its statistics, and its events up to
+  // the same limit as a running thread has
+  void Exit(std::unique_ptr<ThreadProfile> const profile)
+  {
+    std::lock_guard<std::mutex> const lock(mutex);
+
+    threads.erase(std::find(threads.begin(), threads.end(), profile.get()));
+
+    if (profile->record_stats)
+    {
+      exited.Merge(profile->root);
+      exited.Bound(random_state);
+    }
+
+    std::unordered_map<ProfileNode const*, std::string const*> names;
+
+    for (ProfileEvent const& event : profile->events)
+    {
+      if (exited_events.size() >= ThreadProfile::MAX_EVENTS)
+      {
+        exited_dropped_events++;
+        continue;
+      }
+
+      std::string const*& name = names[event.node];
+
+      if (name == nullptr)
+      {
+        name = &*exited_names.insert(event.node->name).first;
+      }
+
+      exited_events.push_back({name, profile->id, event.start, event.end});
+    }
+
+    exited_dropped_events += profile->dropped_events;
+  }
+
+
+  // Hands a thread's profile back to the profiler when the thread exits
+  struct ThreadOwner
+  {
+    std::unique_ptr<ThreadProfile> profile;
+
+    ~ThreadOwner()
+    {
+      if (profile != nullptr)
+      {
+        Instance().Exit(std::move(profile));
+      }
+    }
+  };
+
+
+  static std::string Escape(std::string const& str)
+  {
+    std::string escaped;
+
+    for (char const c : str)
+    {
+      if (c == '"' || c == '\\')
+      {
+        escaped += '\\';
+        escaped += c;
+      }
+      else if (static_cast<unsigned char>(c) < 0x20)
+      {
+        char buffer[8];
+        snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+        escaped += buffer;
+      }
+      else
+      {
+        escaped += c;
+      }
+    }
+
+    return escaped;
+  }
+
+
+  void WriteText(std::ostream& os, Summary& summary, double const spt, int const depth)
+  {
+    for (Summary& child : summary.children)
+    {
+      char line[256];
+
+      snprintf(line, sizeof(line), "%-*s%-*s %10llu %12.6f %12.6f %12.6f %12.6f %12.6f\n",
+        depth * 2, "", 40 - depth * 2, child.name.c_str(),
+        static_cast<unsigned long long>(child.count),
+        child.total * spt * 1e3,
+        child.min * spt * 1e3,
+        child.count > 0 ? child.total * spt * 1e3 / child.count : 0.0,
+        child.max * spt * 1e3,
+        child.Percentile(0.99) * spt * 1e3);
+
+      os << line;
+      WriteText(os, child, spt, depth + 1);
+    }
+  }
+
+
+  void WriteJson(std::ostream& os, Summary& summary, double const spt, std::string const& indent)
+  {
+    os << "[";
+
+    for (size_t i = 0; i < summary.children.size(); i++)
+    {
+      Summary& child = summary.children[i];
+
+      os << (i > 0 ? "," : "") << "\n" << indent << "  {"
+         << "\"name\": \"" << Escape(child.name) << "\", "
+         << "\"calls\": " << child.count << ", "
+         << "\"total_s\": " << child.total * spt << ", "
+         << "\"min_s\": " << child.min * spt << ", "
+         << "\"mean_s\": " << (child.count > 0 ? child.total * spt / child.count : 0.0) << ", "
+         << "\"max_s\": " << child.max * spt << ", "
+         << "\"p99_s\": " << child.Percentile(0.99) * spt << ", "
+         << "\"children\": ";
+
+      WriteJson(os, child, spt, indent + "  ");
+
+      os << "}";
+    }
+
+    os << (summary.children.empty() ? "" : "\n" + indent) << "]";
+  }
+
+
+  void WriteTrace(std::ostream& os, double const spt)
+  {
+    os << "{\"traceEvents\": [";
+
+    bool first = true;
+    uint64_t dropped = exited_dropped_events;
+
+    auto const Write = [&](std::string const& name, unsigned const thread, uint64_t const start, uint64_t const end)
+    {
+      os << (first ? "" : ",") << "\n  {"
+         << "\"name\": \"" << Escape(name) << "\", "
+         << "\"ph\": \"X\", "
+         << "\"ts\": " << (start - clock.Origin()) * spt * 1e6 << ", "
+         << "\"dur\": " << (end - start) * spt * 1e6 << ", "
+         << "\"pid\": 0, "
+         << "\"tid\": " << thread << "}";
+
+      first = false;
+    };
+
+    for (ExitedEvent const& event : exited_events)
+    {
+      Write(*event.name, event.thread, event.start, event.end);
+    }
+
+    for (ThreadProfile const* const thread : threads)
+    {
+      for (ProfileEvent const& event : thread->events)
+      {
+        Write(event.node->name, thread->id, event.start, event.end);
+      }
+
+      dropped += thread->dropped_events;
+    }
+
+    os << "\n], \"otherData\": {\"dropped_events\": " << dropped << "}}\n";
+  }
+
+
+  static bool Requested(std::string_view const report)
+  {
+    char const* const report_env = getenv("TIMESCOPE_REPORT");
+    return report_env != nullptr && std::string_view(report_env).find(report) != std::string_view::npos;
+  }
+
+  static std::string Output()
+  {
+    char const* const output_env = getenv("TIMESCOPE_OUTPUT");
+    return output_env ? output_env : "timescope";
+  }
+
+  Profiler() :
+    report_text(Requested("text")),
+    report_json(Requested("json")),
+    report_trace(Requested("trace")),
+    output(Output())
+  {}
+
+  void Report()
+  {
+    if (!report_text && !report_json && !report_trace)
+    {
+      return;
+    }
+
+    std::lock_guard<std::mutex> const lock(mutex);
+
+    double const spt = clock.SecondsPerTick();
+
+    Summary summary = exited;
+
+    for (ThreadProfile const* const thread : threads)
+    {
+      summary.Merge(thread->root);
+    }
+
+    if (report_text)
+    {
+      char header[256];
+
+      snprintf(header, sizeof(header), "%-40s %10s %12s %12s %12s %12s %12s\n",
+        "scope", "calls", "total (ms)", "min (ms)", "mean (ms)", "max (ms)", "p99 (ms)");
+
+      std::cerr << header;
+      WriteText(std::cerr, summary, spt, 0);
+    }
+
+    if (report_json)
+    {
+      std::ofstream ofs(output + ".json");
+      WriteJson(ofs, summary, spt, "");
+      ofs << "\n";
+    }
+
+    if (report_trace)
+    {
+      std::ofstream ofs(output + ".trace.json");
+      WriteTrace(ofs, spt);
+    }
+  }
+
+
+public:
+  ~Profiler()
+  {
+    Report();
+  }
+
+  static Profiler& Instance()
+  {
+    static Profiler profiler;
+    return profiler;
+  }
+
+  static ThreadProfile& ThisThread()
+  {
+    thread_local ThreadOwner owner;
+
+    if (owner.profile == nullptr)
+    {
+      Profiler& profiler = Instance();
+      std::lock_guard<std::mutex> const lock(profiler.mutex);
+
+      bool const stats = profiler.report_text || profiler.report_json;
+
+      owner.profile = std::make_unique<ThreadProfile>(profiler.thread_count++, stats, profiler.report_trace);
+      profiler.threads.push_back(owner.profile.get());
+    }
+
+    return *owner.profile;
+  }
+};
+
+
+class TimeScope
+{
+private:
+  ThreadProfile& thread;
+  ProfileNode* const node;
+  uint64_t const t_start;
+
+
+public:
+  TimeScope(std::string_view const name) :
+    thread(Profiler::ThisThread()),
+    node(thread.current->Child(name)),
+    t_start(ProfileClock::Now())
+  {
+    thread.current = node;
+  }
+
+  TimeScope(TimeScope const&) = delete;
+  TimeScope& operator=(TimeScope const&) = delete;
 
   ~TimeScope()
   {
-    t_end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> seconds = t_end - t_start;
-    std::cout << name << ": " << seconds.count() << "s" << std::endl;
+    uint64_t const t_end = ProfileClock::Now();
+
+    thread.current = node->parent;
+
+    if (thread.record_stats)
+    {
+      node->Record(t_end - t_start);
+    }
+
+    if (!thread.record_events)
+    {
+      return;
+    }
+
+    if (thread.events.size() < ThreadProfile::MAX_EVENTS)
+    {
+      thread.events.push_back({node, t_start, t_end});
+    }
+    else
+    {
+      thread.dropped_events++;
+    }
   }
 };
 
@@ -1,17 +1,21 @@
-#include "loadints.hpp"
-#include "timescope.hpp"
+#include "solver.hpp"
 
 #include "docopt/docopt.h"
 
 #include <iostream>
 #include <vector>
-#include <set>
+
+
+using namespace day01;
 
 
 static const char USAGE[] =
 R"(Find the product of N numbers which add up to M in a file
 containing a list of numbers.
 
+With --all, every combination of values adding up to the target is printed
+(smallest value first) as it is found, instead of just the first.
+
 Usage:
   a.out [options] <path>
   a.out (-h | --help)
@@ -20,96 +24,64 @@ Options:
   -h --help           Print this help message.
   -t --target <int>   The target value that we are aiming for [default: 2020].
   -c --count <int>    The number of numbers we need to sum [default: 2].
+  -j --threads <int>  Threads to search with, 0 for one per core [default: 1].
+  -a --all            Print every combination, not just the first.
 )";
 
 
-int Min(std::vector<int> const numbers)
+int main(int argc, char **argv)
 {
-  int min = numbers.at(0);
+  std::map<std::string, docopt::value> args =
+    docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
+
+  std::vector<int> numbers;
 
-  for (int const i : numbers)
   {
-    if (i < min)
-    {
-      min = i;
-    }
+    TimeScope t("Parse");
+    numbers = LoadIntsFromFile(args["<path>"].asString());
   }
 
-  return min;
-}
-
+  int const target = args["--target"].asLong();
+  int const count = args["--count"].asLong();
+  unsigned const threads = ThreadCount(args["--threads"].asLong());
 
-std::vector<int> FindNumbersWhichAddTo(
-  int const target,                 // Sum that we want to reach
-  int const count,                  // How many numbers are we looking for?
-  std::vector<int> const numbers,   // Array of numbers
-  int const min,                    // Minimum value in numbers array
-  int const i = 0)                  // Dimensions of loop "1 - up" from this one
-{
-  if (count > 1)
+  if (args["--all"].asBool())
   {
-    for (int j = i; j < numbers.size(); j++)
-    {
-      int const number = numbers.at(j);
+    size_t combinations = 0;
 
-      int const required = target - number;
+    {
+      TimeScope t("Solve");
 
-      if (required >= (count - 1) * min)
+      combinations = SumSearch(numbers).SearchAll(count, target, [](std::vector<int> const& values)
       {
-        std::vector<int> answer = FindNumbersWhichAddTo(required, count - 1, numbers, j, min);
-
-        if (answer.size() != 0)
+        for (size_t i = 0; i < values.size(); i++)
         {
-          answer.push_back(number);
-          return answer;
+          std::cout << (i > 0 ? " " : "") << values[i];
         }
-      }
-    }
-  }
-  else
-  {
-    for (int j = i; j < numbers.size(); j++)
-    {
-      int const number = numbers.at(j);
 
-      if (number == target)
-      {
-        return {number};
-      }
+        std::cout << '\n';
+      });
     }
-  }
-
-  // Oh no!
-  return {};
-}
-
-
-std::vector<int> FindNumbersWhichAddTo(
-  int const target,                 // Sum that we want to reach
-  int const count,                  // How many numbers are we looking for?
-  std::vector<int> const numbers)   // Array of numbers
-{
-  return FindNumbersWhichAddTo(target, count, numbers, Min(numbers));
-}
 
+    if (combinations == 0)
+    {
+      std::cerr << "Oh no! We didn't find the numbers!" << std::endl;
+      return 1;
+    }
 
-int main(int argc, char **argv)
-{
-  std::map<std::string, docopt::value> args =
-    docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
+    std::cout << "combinations: " << combinations << std::endl;
 
-  std::vector<int> numbers = LoadIntsFromFile(args["<path>"].asString());
-  int const target = args["--target"].asLong();
-  int const count = args["--count"].asLong();
+    return 0;
+  }
 
   std::vector<int> answers;
 
   {
-    TimeScope t("Computation duration");
-    answers = FindNumbersWhichAddTo(target, count, numbers);
+    TimeScope t("Solve");
+    answers = FindNumbersWhichAddTo(target, count, numbers, threads);
   }
 
-  if (answers.size() != count)
+  if (answers.size() != static_cast<size_t>(count))
   {
     std::cerr << "Oh no! We didn't find the numbers!" << std::endl;
     return 1;
@@ -0,0 +1,817 @@
+#ifndef DAY01_SOLVER_INCLUDED
+#define DAY01_SOLVER_INCLUDED
+
+#include "loadints.hpp"
+#include "timescope.hpp"
+#include "threadpool.hpp"
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <future>
+#include <utility>
+
+#include <unistd.h>
+
+
+namespace day01
+{
+
+
+// Finds count numbers, at distinct positions, which add up to a target.
+//
+// The search runs over the distinct values in ascending order along with how
+// often each one occurs, so repeated numbers cost nothing, and the values
+// still to be chosen can never be smaller than the last one, which bounds
+// the search from both ends. The innermost pair is a two pointer sweep over
+// the sorted values, except for four or more numbers, which meet in the
+// middle: every pair of values is indexed by its sum, so the last pair is a
+// lookup instead of a sweep, and four numbers cost O(V^2) rather than
+// O(V^3). The index takes up to 16 bytes a pair, and is only built if it
+// fits in a quarter of the memory (about 23000 distinct values with 16GB);
+// past that the sweeps are used.
+//
+// Of all the answers, the one found is the one whose values (ascending) come
+// first, so it does not depend on how the search is carried out.
+class SumSearch
+{
+private:
+  std::vector<int> const& numbers;
+
+  // Positions of the numbers, sorted by value, and where each distinct value
+  // starts in there
+  std::vector<uint32_t> order;
+  std::vector<uint32_t> first;
+
+  std::vector<int64_t> values;
+  std::vector<uint32_t> counts;
+
+  // Every pair of indices a <= b into values (a == b only for a repeated
+  // value), bucketed by (sum - pair_sum_min) >> pair_shift. The pairs in
+  // bucket i start at pair_buckets[i], in order of a.
+  struct Pair
+  {
+    uint32_t a;
+    uint32_t b;
+  };
+
+  std::vector<Pair> pairs;
+  std::vector<uint32_t> pair_buckets;
+  int64_t pair_sum_min = 0;
+  int pair_shift = 0;
+  bool pairs_built = false;
+
+
+  // A candidate answer, as indices into values. Each thread searching has
+  // its own.
+  struct Candidate
+  {
+    std::vector<uint32_t> used;
+    std::vector<uint32_t> chosen;
+
+    // In a parallel search, the smallest first value (index) any thread has
+    // an answer for; the candidate is dropped once it can no longer win
+    std::atomic<size_t> const* best_first = nullptr;
+
+    bool Cancelled() const
+    {
+      return best_first != nullptr && !chosen.empty() &&
+        best_first->load(std::memory_order_relaxed) < chosen.front();
+    }
+  };
+
+
+  Candidate NewCandidate() const
+  {
+    Candidate candidate;
+    candidate.used.resize(values.size());
+    return candidate;
+  }
+
+
+  bool Available(Candidate const& candidate, size_t const i, uint32_t const needed = 1) const
+  {
+    return counts[i] - candidate.used[i] >= needed;
+  }
+
+
+  static void Choose(Candidate& candidate, size_t const i)
+  {
+    candidate.used[i]++;
+    candidate.chosen.push_back(i);
+  }
+
+
+  static void Unchoose(Candidate& candidate)
+  {
+    candidate.used[candidate.chosen.back()]--;
+    candidate.chosen.pop_back();
+  }
+
+
+  static size_t MemoryBudget()
+  {
+    long const pages = sysconf(_SC_PHYS_PAGES);
+    long const page_size = sysconf(_SC_PAGE_SIZE);
+
+    if (pages <= 0 || page_size <= 0)
+    {
+      return size_t(1) << 30;
+    }
+
+    return static_cast<size_t>(pages) * page_size / 4;
+  }
+
+
+  template<class Fn>
+  void ForEachPair(Fn&& fn) const
+  {
+    for (uint32_t a = 0; a < values.size(); a++)
+    {
+      for (uint32_t b = counts[a] > 1 ? a : a + 1; b < values.size(); b++)
+      {
+        fn(a, b);
+      }
+    }
+  }
+
+
+  // There are about as many buckets as pairs (fewer if the sums span less),
+  // and the pairs are counted into them and then placed, which keeps them in
+  // the order they are made in
+  void BuildPairs()
+  {
+    pairs_built = true;
+
+    size_t pair_count = values.size() * (values.size() - 1) / 2;
+
+    for (uint32_t const count : counts)
+    {
+      pair_count += count > 1;
+    }
+
+    uint64_t const sum_range = static_cast<uint64_t>(values.back() - values.front()) * 2 + 1;
+    size_t bucket_count = 1;
+    int shift = 0;
+
+    while (bucket_count < std::min<uint64_t>(pair_count, sum_range))
+    {
+      bucket_count *= 2;
+    }
+
+    while (((sum_range - 1) >> shift) >= bucket_count)
+    {
+      shift++;
+    }
+
+    size_t const bytes = pair_count * sizeof(Pair) + (bucket_count + 1) * sizeof(uint32_t);
+
+    if (pair_count >= UINT32_MAX || bytes > MemoryBudget())
+    {
+      return;
+    }
+
+    pair_sum_min = values.front() * 2;
+    pair_shift = shift;
+    pair_buckets.assign(bucket_count + 1, 0);
+
+    ForEachPair([&](uint32_t const a, uint32_t const b)
+    {
+      pair_buckets[PairBucket(values[a] + values[b]) + 1]++;
+    });
+
+    for (size_t i = 1; i <= bucket_count; i++)
+    {
+      pair_buckets[i] += pair_buckets[i - 1];
+    }
+
+    // Placing a pair moves its bucket's start on to the next one's, so the
+    // starts end up one bucket along
+    pairs.resize(pair_count);
+
+    ForEachPair([&](uint32_t const a, uint32_t const b)
+    {
+      pairs[pair_buckets[PairBucket(values[a] + values[b])]++] = {a, b};
+    });
+
+    std::rotate(pair_buckets.begin(), pair_buckets.end() - 1, pair_buckets.end());
+    pair_buckets[0] = 0;
+  }
+
+
+  uint64_t PairBucket(int64_t const sum) const
+  {
+    return static_cast<uint64_t>(sum - pair_sum_min) >> pair_shift;
+  }
+
+
+  // The pairs in the bucket target falls in whose first index is at least
+  // from, which need their sums checked
+  std::pair<Pair const*, Pair const*> PairsInBucket(int64_t const target, size_t const from) const
+  {
+    if (target < pair_sum_min || PairBucket(target) + 1 >= pair_buckets.size())
+    {
+      return {nullptr, nullptr};
+    }
+
+    uint64_t const bucket = PairBucket(target);
+    Pair const* const begin = pairs.data() + pair_buckets[bucket];
+    Pair const* const end = pairs.data() + pair_buckets[bucket + 1];
+
+    auto const Before = [](Pair const& pair, size_t const index)
+    {
+      return pair.a < index;
+    };
+
+    return {std::lower_bound(begin, end, from, Before), end};
+  }
+
+
+  // Whether a pair adds up to target and none of its values are used up,
+  // which is what keeps it apart from the numbers already chosen
+  bool PairFits(Candidate const& candidate, Pair const& pair, int64_t const target) const
+  {
+    return values[pair.a] + values[pair.b] == target &&
+      (pair.a == pair.b ? Available(candidate, pair.a, 2) : Available(candidate, pair.a) && Available(candidate, pair.b));
+  }
+
+
+  bool FindOne(Candidate& candidate, int64_t const target, size_t const from) const
+  {
+    auto const it = std::lower_bound(values.begin() + from, values.end(), target);
+
+    if (it == values.end() || *it != target || !Available(candidate, it - values.begin()))
+    {
+      return false;
+    }
+
+    Choose(candidate, it - values.begin());
+    return true;
+  }
+
+
+  bool FindPair(Candidate& candidate, int64_t const target, size_t const from) const
+  {
+    if (!pair_buckets.empty())
+    {
+      auto const [begin, end] = PairsInBucket(target, from);
+
+      for (Pair const* pair = begin; pair != end; pair++)
+      {
+        if (PairFits(candidate, *pair, target))
+        {
+          Choose(candidate, pair->a);
+          Choose(candidate, pair->b);
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    size_t lo = from;
+    size_t hi = values.size() - 1;
+
+    while (lo <= hi && hi < values.size())
+    {
+      if (!Available(candidate, lo))
+      {
+        lo++;
+        continue;
+      }
+
+      if (!Available(candidate, hi))
+      {
+        hi--;
+        continue;
+      }
+
+      int64_t const sum = values[lo] + values[hi];
+
+      if (sum < target)
+      {
+        lo++;
+      }
+      else if (sum > target)
+      {
+        hi--;
+      }
+      else
+      {
+        if (lo == hi && !Available(candidate, lo, 2))
+        {
+          return false;
+        }
+
+        Choose(candidate, lo);
+        Choose(candidate, hi);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+
+  bool Find(Candidate& candidate, int const count, int64_t const target, size_t const from) const
+  {
+    if (count == 1)
+    {
+      return FindOne(candidate, target, from);
+    }
+
+    if (count == 2)
+    {
+      return FindPair(candidate, target, from);
+    }
+
+    for (size_t i = from; i < values.size(); i++)
+    {
+      int64_t const value = values[i];
+
+      // Everything still to be chosen is at least this value
+      if (value * count > target || candidate.Cancelled())
+      {
+        break;
+      }
+
+      if (!Available(candidate, i) || value + (count - 1) * values.back() < target)
+      {
+        continue;
+      }
+
+      Choose(candidate, i);
+
+      if (Find(candidate, count - 1, target - value, i))
+      {
+        return true;
+      }
+
+      Unchoose(candidate);
+    }
+
+    return false;
+  }
+
+
+  // Like Find, but carries on after each answer, passing the candidate to
+  // found, and returns how many answers there were
+  template<class Fn>
+  size_t FindAll(Candidate& candidate, int const count, int64_t const target, size_t const from, Fn& found) const
+  {
+    size_t answers = 0;
+
+    if (count == 1)
+    {
+      if (FindOne(candidate, target, from))
+      {
+        found(candidate);
+        Unchoose(candidate);
+        answers++;
+      }
+
+      return answers;
+    }
+
+    if (count == 2)
+    {
+      if (!pair_buckets.empty())
+      {
+        auto const [begin, end] = PairsInBucket(target, from);
+
+        for (Pair const* pair = begin; pair != end; pair++)
+        {
+          if (PairFits(candidate, *pair, target))
+          {
+            Choose(candidate, pair->a);
+            Choose(candidate, pair->b);
+            found(candidate);
+            Unchoose(candidate);
+            Unchoose(candidate);
+            answers++;
+          }
+        }
+
+        return answers;
+      }
+
+      size_t lo = from;
+      size_t hi = values.size() - 1;
+
+      while (lo <= hi && hi < values.size())
+      {
+        if (!Available(candidate, lo))
+        {
+          lo++;
+          continue;
+        }
+
+        if (!Available(candidate, hi))
+        {
+          hi--;
+          continue;
+        }
+
+        int64_t const sum = values[lo] + values[hi];
+
+        if (sum < target)
+        {
+          lo++;
+        }
+        else if (sum > target)
+        {
+          hi--;
+        }
+        else
+        {
+          if (lo == hi && !Available(candidate, lo, 2))
+          {
+            break;
+          }
+
+          Choose(candidate, lo);
+          Choose(candidate, hi);
+          found(candidate);
+          Unchoose(candidate);
+          Unchoose(candidate);
+          answers++;
+
+          lo++;
+          hi--;
+        }
+      }
+
+      return answers;
+    }
+
+    for (size_t i = from; i < values.size(); i++)
+    {
+      int64_t const value = values[i];
+
+      if (value * count > target)
+      {
+        break;
+      }
+
+      if (!Available(candidate, i) || value + (count - 1) * values.back() < target)
+      {
+        continue;
+      }
+
+      Choose(candidate, i);
+      answers += FindAll(candidate, count - 1, target - value, i, found);
+      Unchoose(candidate);
+    }
+
+    return answers;
+  }
+
+
+  // Threads take the first value of the candidates one at a time from a
+  // shared counter, so one slow first value never holds up the rest. Every
+  // first value below the best one found is searched to the end, which is
+  // what makes the answer the same as the serial one.
+  bool FindParallel(Candidate& best, int const count, int64_t const target, unsigned const threads) const
+  {
+    std::atomic<size_t> next_first{0};
+    std::atomic<size_t> best_first{values.size()};
+    std::mutex mutex;
+
+    auto const Work = [&]
+    {
+      Candidate candidate = NewCandidate();
+      candidate.best_first = &best_first;
+
+      while (true)
+      {
+        size_t const i = next_first++;
+
+        if (i >= best_first.load() || values[i] * count > target)
+        {
+          return;
+        }
+
+        if (values[i] + (count - 1) * values.back() < target)
+        {
+          continue;
+        }
+
+        Choose(candidate, i);
+
+        if (Find(candidate, count - 1, target - values[i], i))
+        {
+          std::lock_guard<std::mutex> const lock(mutex);
+
+          if (i < best_first.load())
+          {
+            best = candidate;
+            best_first = i;
+          }
+        }
+
+        while (!candidate.chosen.empty())
+        {
+          Unchoose(candidate);
+        }
+      }
+    };
+
+    {
+      ThreadPool pool(threads);
+      std::vector<std::future<void>> workers;
+
+      for (size_t i = 0; i < pool.Size(); i++)
+      {
+        workers.push_back(pool.Submit(Work));
+      }
+
+      for (std::future<void>& worker : workers)
+      {
+        worker.get();
+      }
+    }
+
+    return best_first.load() < values.size();
+  }
+
+
+  // The numbers of a candidate, last in the input first (the order the old
+  // nested loop search gave them in). Repeated values take their earliest
+  // positions.
+  std::vector<int> Answer(Candidate const& candidate) const
+  {
+    std::vector<uint32_t> positions;
+
+    for (size_t i = 0; i < candidate.chosen.size(); i++)
+    {
+      uint32_t const value = candidate.chosen[i];
+      size_t const repeat = std::count(candidate.chosen.begin(), candidate.chosen.begin() + i, value);
+      positions.push_back(order[first[value] + repeat]);
+    }
+
+    std::sort(positions.rbegin(), positions.rend());
+
+    std::vector<int> answer;
+
+    for (uint32_t const position : positions)
+    {
+      answer.push_back(numbers[position]);
+    }
+
+    return answer;
+  }
+
+
+public:
+  SumSearch(std::vector<int> const& numbers) :
+    numbers(numbers),
+    order(numbers.size())
+  {
+    // Sorting value and position packed into one integer is a good deal
+    // faster than sorting positions through a comparison on the values
+    std::vector<uint64_t> keys(numbers.size());
+
+    for (uint32_t i = 0; i < keys.size(); i++)
+    {
+      uint32_t const biased = static_cast<uint32_t>(numbers[i]) ^ 0x80000000u;
+      keys[i] = (static_cast<uint64_t>(biased) << 32) | i;
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    for (uint32_t i = 0; i < keys.size(); i++)
+    {
+      order[i] = static_cast<uint32_t>(keys[i]);
+
+      int const value = numbers[order[i]];
+
+      if (values.empty() || values.back() != value)
+      {
+        values.push_back(value);
+        counts.push_back(0);
+        first.push_back(i);
+      }
+
+      counts.back()++;
+    }
+  }
+
+
+  // The numbers found (see Answer), or nothing if there is no answer. Unless
+  // told to use one thread, three or more numbers are searched in parallel
+  // (0 threads is one per core).
+  std::vector<int> Search(int const count, int64_t const target, unsigned const threads = 1)
+  {
+    if (count < 1 || static_cast<size_t>(count) > numbers.size())
+    {
+      return {};
+    }
+
+    // For three numbers the index costs as much as the search it saves
+    if (count >= 4 && !pairs_built)
+    {
+      BuildPairs();
+    }
+
+    Candidate candidate = NewCandidate();
+
+    bool const found = (threads != 1 && count >= 3) ?
+      FindParallel(candidate, count, target, threads) :
+      Find(candidate, count, target, 0);
+
+    if (!found)
+    {
+      return {};
+    }
+
+    return Answer(candidate);
+  }
+
+
+  // Calls found with the values (ascending) of every combination of count
+  // numbers which add up to target, as each one is found, and returns how
+  // many there were. Numbers with the same value are interchangeable, so
+  // each combination of values is given once. Nothing is kept from one
+  // combination to the next, so memory does not grow with their number.
+  template<class Fn>
+  size_t SearchAll(int const count, int64_t const target, Fn&& found)
+  {
+    if (count < 1 || static_cast<size_t>(count) > numbers.size())
+    {
+      return 0;
+    }
+
+    if (count >= 4 && !pairs_built)
+    {
+      BuildPairs();
+    }
+
+    Candidate candidate = NewCandidate();
+    std::vector<int> combination;
+
+    auto report = [&](Candidate const& answer)
+    {
+      combination.clear();
+
+      for (uint32_t const i : answer.chosen)
+      {
+        combination.push_back(values[i]);
+      }
+
+      found(combination);
+    };
+
+    return FindAll(candidate, count, target, 0, report);
+  }
+};
+
+
+// Two numbers, at distinct positions, which add up to target, without
+// sorting: one pass puts the first two positions of each value in a hash
+// set (open addressing, as the values are plain ints), and another looks up
+// each value's partner. The answer is the same one SumSearch gives (see
+// Answer).
+inline std::vector<int> FindPairWhichAddsTo(int64_t const target, std::vector<int> const& numbers)
+{
+  uint32_t const NONE = UINT32_MAX;
+
+  struct Slot
+  {
+    int value;
+    uint32_t first = NONE;  // NONE for an empty slot
+    uint32_t second = NONE;
+  };
+
+  int shift = 31;
+
+  while ((size_t(1) << (32 - shift)) < numbers.size() * 2)
+  {
+    shift--;
+  }
+
+  std::vector<Slot> slots(size_t(1) << (32 - shift));
+  size_t const mask = slots.size() - 1;
+
+  auto const Find = [&](int const value) -> Slot&
+  {
+    size_t i = (static_cast<uint32_t>(value) * 0x9e3779b1u) >> shift;
+
+    while (slots[i].first != NONE && slots[i].value != value)
+    {
+      i = (i + 1) & mask;
+    }
+
+    return slots[i];
+  };
+
+  for (uint32_t i = 0; i < numbers.size(); i++)
+  {
+    Slot& slot = Find(numbers[i]);
+
+    if (slot.first == NONE)
+    {
+      slot = {numbers[i], i, NONE};
+    }
+    else if (slot.second == NONE)
+    {
+      slot.second = i;
+    }
+  }
+
+  // The pair with the smallest smaller value
+  Slot const* best = nullptr;
+  Slot const* best_partner = nullptr;
+
+  for (Slot const& slot : slots)
+  {
+    int64_t const partner = target - slot.value;
+
+    if (slot.first == NONE || partner < slot.value || (best != nullptr && slot.value >= best->value) ||
+        partner > INT32_MAX)
+    {
+      continue;
+    }
+
+    Slot const& found = Find(static_cast<int>(partner));
+
+    if (found.first != NONE && (partner != slot.value || slot.second != NONE))
+    {
+      best = &slot;
+      best_partner = &found;
+    }
+  }
+
+  if (best == nullptr)
+  {
+    return {};
+  }
+
+  uint32_t const a = best->first;
+  uint32_t const b = (best == best_partner) ? best->second : best_partner->first;
+
+  // Last in the input first
+  return (a > b) ? std::vector<int>{numbers[a], numbers[b]} : std::vector<int>{numbers[b], numbers[a]};
+}
+
+
+inline std::vector<int> FindNumbersWhichAddTo(
+  int64_t const target,             // Sum that we want to reach
+  int const count,                  // How many numbers are we looking for?
+  std::vector<int> const& numbers,  // Array of numbers
+  unsigned const threads = 1)       // Threads to search with
+{
+  if (count == 2)
+  {
+    return FindPairWhichAddsTo(target, numbers);
+  }
+
+  return SumSearch(numbers).Search(count, target, threads);
+}
+
+
+inline std::string SolveCounts(std::string_view const input, int const min_count, int const max_count)
+{
+  std::vector<int> const numbers = LoadIntsFromBuffer(input, "input");
+  SumSearch search(numbers);
+  std::stringstream ss;
+
+  for (int count = min_count; count <= max_count; count++)
+  {
+    std::vector<int> const answer = search.Search(count, 2020);
+
+    if (answer.empty())
+    {
+      ss << "product (" << count << "): none" << std::endl;
+      continue;
+    }
+
+    int64_t product = 1;
+
+    for (int const i : answer)
+    {
+      product *= i;
+    }
+
+    ss << "product (" << count << "): " << product << std::endl;
+  }
+
+  return ss.str();
+}
+
+
+// Both parts of the puzzle, pairs and triples adding to 2020
+inline std::string Solve(std::string_view const input)
+{
+  return SolveCounts(input, 2, 3);
+}
+
+
+} // namespace day01
+
+
+#endif // DAY01_SOLVER_INCLUDED
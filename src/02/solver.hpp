@@ -0,0 +1,423 @@
+#ifndef DAY02_SOLVER_INCLUDED
+#define DAY02_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "mappedfile.hpp"
+#include "stringutil.hpp"
+#include "threadpool.hpp"
+#include "timescope.hpp"
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <future>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+namespace day02
+{
+
+
+// Password policies ("1-3 a: abcde"), parsed once and stored column by
+// column so that checking them is a tight loop over plain arrays. A batch
+// holds up to CAPACITY lines, so a file of any size goes through a few
+// thousand lines at a time and the columns stay in cache.
+struct PolicyBatch
+{
+  static size_t const CAPACITY = 4096;
+
+  char const* base = nullptr;  // passwords are at base + offset
+  char const* end = nullptr;   // end of the buffer they are in
+  size_t size = 0;
+
+  std::vector<uint16_t> low;
+  std::vector<uint16_t> high;
+  std::vector<char> letter;
+  std::vector<uint32_t> offset;
+  std::vector<uint32_t> length;
+
+  PolicyBatch() :
+    low(CAPACITY),
+    high(CAPACITY),
+    letter(CAPACITY),
+    offset(CAPACITY),
+    length(CAPACITY)
+  {}
+};
+
+
+[[noreturn]] inline void Malformed(std::string_view const line)
+{
+  std::cerr << "Malformed policy: '" << line << "'" << std::endl;
+  exit(1);
+}
+
+
+// Appends one line to the batch, blank lines are skipped
+inline void ParsePolicy(std::string_view const line, PolicyBatch& batch)
+{
+  std::string_view const policy = trim(line);
+  size_t i = 0;
+
+  if (policy.empty())
+  {
+    return;
+  }
+
+  auto const Number = [&]
+  {
+    if (i >= policy.size() || policy[i] < '0' || policy[i] > '9')
+    {
+      Malformed(line);
+    }
+
+    uint32_t value = 0;
+
+    for (; i < policy.size() && policy[i] >= '0' && policy[i] <= '9'; i++)
+    {
+      value = value * 10 + (policy[i] - '0');
+
+      if (value > UINT16_MAX)
+      {
+        Malformed(line);
+      }
+    }
+
+    return static_cast<uint16_t>(value);
+  };
+
+  auto const Skip = [&](char const c)
+  {
+    size_t const start = i;
+
+    while (i < policy.size() && policy[i] == c)
+    {
+      i++;
+    }
+
+    if (i == start)
+    {
+      Malformed(line);
+    }
+  };
+
+  size_t const n = batch.size;
+
+  batch.low[n] = Number();
+  Skip('-');
+  batch.high[n] = Number();
+  Skip(' ');
+
+  if (i >= policy.size())
+  {
+    Malformed(line);
+  }
+
+  batch.letter[n] = policy[i++];
+  Skip(':');
+
+  std::string_view const password = ltrim(policy.substr(i));
+
+  batch.offset[n] = password.data() - batch.base;
+  batch.length[n] = password.size();
+  batch.size++;
+}
+
+
+// Parses lines from start until the batch is full or the buffer runs out,
+// and returns where the next batch starts
+inline size_t ParsePolicies(std::string_view const buffer, size_t const start, PolicyBatch& batch)
+{
+  char const* const data = buffer.data();
+  size_t pos = start;
+
+  batch.base = data + start;
+  batch.end = data + buffer.size();
+  batch.size = 0;
+
+  while (pos < buffer.size() && batch.size < PolicyBatch::CAPACITY)
+  {
+    void const* const newline = memchr(data + pos, '\n', buffer.size() - pos);
+    size_t const line_end = newline ? static_cast<char const*>(newline) - data : buffer.size();
+
+    ParsePolicy(buffer.substr(pos, line_end - pos), batch);
+    pos = line_end + 1;
+  }
+
+  return std::min(pos, buffer.size());
+}
+
+
+// How often c appears in the length bytes at data. Whole vectors are
+// compared even when they run past the password (never past end), and the
+// bytes beyond it are masked off before counting.
+inline uint32_t CountChar(char const* const data, uint32_t const length, char const c, char const* const end)
+{
+  uint32_t count = 0;
+  uint32_t i = 0;
+
+#if defined(__AVX2__)
+  __m256i const needle = _mm256_set1_epi8(c);
+
+  for (; i < length && data + i + 32 <= end; i += 32)
+  {
+    __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + i));
+    uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+
+    if (length - i < 32)
+    {
+      mask &= (1u << (length - i)) - 1;
+    }
+
+    count += __builtin_popcount(mask);
+  }
+#elif defined(__SSE2__)
+  __m128i const needle = _mm_set1_epi8(c);
+
+  for (; i < length && data + i + 16 <= end; i += 16)
+  {
+    __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+    uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+
+    if (length - i < 16)
+    {
+      mask &= (1u << (length - i)) - 1;
+    }
+
+    count += __builtin_popcount(mask);
+  }
+#endif
+
+  for (; i < length; i++)
+  {
+    count += (data[i] == c);
+  }
+
+  return count;
+}
+
+
+// Mode 1: the letter appears between low and high times
+inline size_t CountValidByCount(PolicyBatch const& batch)
+{
+  size_t valid = 0;
+
+  for (size_t i = 0; i < batch.size; i++)
+  {
+    uint32_t const count = CountChar(batch.base + batch.offset[i], batch.length[i], batch.letter[i], batch.end);
+    valid += (count >= batch.low[i] && count <= batch.high[i]);
+  }
+
+  return valid;
+}
+
+
+// Mode 2: the letter is at exactly one of the (1-based) positions low and
+// high. A position outside the password never holds the letter.
+inline size_t CountValidByPosition(PolicyBatch const& batch)
+{
+  size_t valid = 0;
+  size_t i = 0;
+
+#if defined(__AVX2__)
+  // Eight policies at a time, gathering the four bytes at each position and
+  // comparing the first. That may read three bytes past the last password,
+  // so the last group before the end of the buffer is left to the loop below.
+  __m256i const sign = _mm256_set1_epi32(INT32_MIN);
+  __m256i const one = _mm256_set1_epi32(1);
+  __m256i const byte = _mm256_set1_epi32(0xff);
+  int const* const base = reinterpret_cast<int const*>(batch.base);
+
+  auto const Holds = [&](__m256i const offset, __m256i const length, __m256i const letter, __m256i const position)
+  {
+    __m256i const index = _mm256_sub_epi32(position, one);
+
+    // Unsigned index < length, so position 0 is outside too
+    __m256i const inside = _mm256_cmpgt_epi32(_mm256_xor_si256(length, sign), _mm256_xor_si256(index, sign));
+    __m256i const found = _mm256_mask_i32gather_epi32(
+      _mm256_setzero_si256(), base, _mm256_add_epi32(offset, index), inside, 1);
+
+    return _mm256_and_si256(inside, _mm256_cmpeq_epi32(_mm256_and_si256(found, byte), letter));
+  };
+
+  for (; i + 8 <= batch.size && batch.base + batch.offset[i + 7] + batch.length[i + 7] + 4 <= batch.end; i += 8)
+  {
+    __m256i const offset = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(&batch.offset[i]));
+    __m256i const length = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(&batch.length[i]));
+    __m256i const letter = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(&batch.letter[i])));
+    __m256i const low = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&batch.low[i])));
+    __m256i const high = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&batch.high[i])));
+
+    __m256i const either = _mm256_xor_si256(Holds(offset, length, letter, low), Holds(offset, length, letter, high));
+    valid += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(either)));
+  }
+#endif
+
+  for (; i < batch.size; i++)
+  {
+    char const* const password = batch.base + batch.offset[i];
+    uint32_t const first = batch.low[i] - 1u;
+    uint32_t const second = batch.high[i] - 1u;
+
+    bool const at_first = first < batch.length[i] && password[first] == batch.letter[i];
+    bool const at_second = second < batch.length[i] && password[second] == batch.letter[i];
+
+    valid += (at_first != at_second);
+  }
+
+  return valid;
+}
+
+
+// Counts the valid passwords in a buffer of policy lines
+inline size_t CountValid(std::string_view const buffer, int const mode)
+{
+  if (mode != 1 && mode != 2)
+  {
+    std::cerr << mode << " is not a recognised mode!" << std::endl;
+    exit(1);
+  }
+
+  PolicyBatch batch;
+  size_t valid = 0;
+
+  for (size_t pos = 0; pos < buffer.size();)
+  {
+    pos = ParsePolicies(buffer, pos, batch);
+    valid += (mode == 1) ? CountValidByCount(batch) : CountValidByPosition(batch);
+  }
+
+  return valid;
+}
+
+
+// Same, over chunks of the buffer on a pool of threads (0 for one per
+// core). Each chunk is a few times smaller than an even share, so a slow
+// chunk doesn't leave the other threads idle at the end.
+inline size_t CountValid(std::string_view const buffer, int const mode, unsigned const threads)
+{
+  if (threads == 1)
+  {
+    return CountValid(buffer, mode);
+  }
+
+  ThreadPool pool(threads);
+  size_t const chunk_size = std::max<size_t>(buffer.size() / (pool.Size() * 4), 1 << 20);
+  std::vector<std::future<size_t>> counts;
+
+  for (std::string_view const chunk : SplitIntoChunks(buffer, chunk_size))
+  {
+    counts.push_back(pool.Submit([chunk, mode] { return CountValid(chunk, mode); }));
+  }
+
+  size_t valid = 0;
+
+  for (std::future<size_t>& count : counts)
+  {
+    valid += count.get();
+  }
+
+  return valid;
+}
+
+
+// Same, reading the lines from a stream (e.g. stdin) a block at a time, so
+// memory use doesn't depend on the size of the input. Only whole lines are
+// checked; the partial line at the end of a block is moved to the front and
+// finished by the next read. The buffer only grows for a line longer than
+// a block.
+inline size_t CountValid(FILE* const stream, int const mode, size_t const block_size = 1 << 20)
+{
+  std::vector<char> buffer(std::max<size_t>(block_size, 1));
+  size_t filled = 0;
+  size_t valid = 0;
+
+  while (true)
+  {
+    if (filled == buffer.size())
+    {
+      buffer.resize(buffer.size() * 2);
+    }
+
+    size_t const read = fread(buffer.data() + filled, 1, buffer.size() - filled, stream);
+
+    if (read == 0)
+    {
+      if (ferror(stream))
+      {
+        std::cerr << "Error reading the input" << std::endl;
+        exit(1);
+      }
+
+      break;
+    }
+
+    filled += read;
+
+    size_t complete = filled;
+
+    while (complete > 0 && buffer[complete - 1] != '\n')
+    {
+      complete--;
+    }
+
+    valid += CountValid(std::string_view(buffer.data(), complete), mode);
+
+    memmove(buffer.data(), buffer.data() + complete, filled - complete);
+    filled -= complete;
+  }
+
+  // The last line, if it has no newline
+  return valid + CountValid(std::string_view(buffer.data(), filled), mode);
+}
+
+
+// The counts for both modes, from one parse of the buffer
+struct ValidCounts
+{
+  size_t by_count = 0;     // mode 1
+  size_t by_position = 0;  // mode 2
+};
+
+
+inline ValidCounts CountValidBothModes(std::string_view const buffer)
+{
+  PolicyBatch batch;
+  ValidCounts valid;
+
+  for (size_t pos = 0; pos < buffer.size();)
+  {
+    pos = ParsePolicies(buffer, pos, batch);
+    valid.by_count += CountValidByCount(batch);
+    valid.by_position += CountValidByPosition(batch);
+  }
+
+  return valid;
+}
+
+
+inline std::string Solve(std::string_view const input)
+{
+  ValidCounts const valid = CountValidBothModes(input);
+  std::stringstream ss;
+
+  ss << "mode 1: " << valid.by_count << std::endl;
+  ss << "mode 2: " << valid.by_position << std::endl;
+
+  return ss.str();
+}
+
+
+} // namespace day02
+
+
+#endif // DAY02_SOLVER_INCLUDED
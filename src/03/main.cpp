@@ -1,21 +1,34 @@
-#include "loadlines.hpp"
+#include "solver.hpp"
 
 #include "docopt/docopt.h"
 
 #include <iostream>
 
 
+using namespace day03;
+
+
 static const char USAGE[] =
 R"(Toboggan tree collision avoidance system v1.0.
 
+With --slopes, every slope in the list is counted in one pass over the map.
+With --sweep, every slope in the dx and dy ranges (e.g. -10..10 and 1..5) is
+counted (on a pool of threads with --threads), and those with the fewest
+and the most collisions are reported.
+
 Usage:
   a.out [options] <path>
   a.out (-h | --help)
 
 Options:
-  -h --help       Print this help message.
-  -x --dx <int>   Downward steps per iteration [default: 3].
-  -y --dy <int>   Rightward steps per iteration [default: 1].
+  -h --help             Print this help message.
+  -x --dx <int>         Rightward steps per iteration [default: 3].
+  -y --dy <int>         Downward steps per iteration [default: 1].
+  -s --slopes <list>    Comma separated dx:dy slopes, e.g. 1:1,3:1,1:2.
+  --sweep               Sweep the slopes in --dx-range and --dy-range.
+  --dx-range <range>    dx values to sweep [default: 0..100].
+  --dy-range <range>    dy values to sweep [default: 1..10].
+  -j --threads <int>    Threads to sweep with, 0 for one per core [default: 1].
 )";
 
 
@@ -24,22 +37,67 @@ int main(int argc, char **argv)
   auto args = docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
 
   std::string const path = args["<path>"].asString();
-  std::vector<std::string> const tree_map = LoadLinesFromFile(path);
+  MappedFile const file(path);
+  TreeMap const tree_map(file.View());
 
-  int const dx = args["--dx"].asLong();
-  int const dy = args["--dy"].asLong();
+  if (args["--sweep"].asBool())
+  {
+    auto const [dx_min, dx_max] = ParseRange(args["--dx-range"].asString());
+    auto const [dy_min, dy_max] = ParseRange(args["--dy-range"].asString());
 
-  int x = 0, y = 0, ouch = 0;
+    if (dy_min < 1)
+    {
+      std::cerr << "dy must be at least 1" << std::endl;
+      return 1;
+    }
+
+    unsigned const threads = ThreadCount(args["--threads"].asLong());
+    SweepResult result;
+
+    {
+      TimeScope t("Solve");
+      result = SweepSlopes(tree_map, dx_min, dx_max, dy_min, dy_max, threads);
+    }
+
+    std::cout << "slopes: " << result.slopes << std::endl;
+    std::cout << "fewest: " << result.fewest.dx << ":" << result.fewest.dy << " " << result.fewest_collisions << std::endl;
+    std::cout << "most: " << result.most.dx << ":" << result.most.dy << " " << result.most_collisions << std::endl;
+
+    return 0;
+  }
 
-  while (y < tree_map.size())
+  if (args["--slopes"])
   {
-    if (tree_map.at(y)[x % tree_map.at(y).size()] == '#')
+    std::vector<Slope> const slopes = ParseSlopes(args["--slopes"].asString());
+    std::vector<int> ouch;
+
+    {
+      TimeScope t("Solve");
+      ouch = CountCollisions(tree_map, slopes);
+    }
+
+    for (size_t i = 0; i < slopes.size(); i++)
     {
-      ouch++;
+      std::cout << slopes[i].dx << ":" << slopes[i].dy << " " << ouch[i] << std::endl;
     }
 
-    x += dx;
-    y += dy;
+    return 0;
+  }
+
+  int const dx = args["--dx"].asLong();
+  int const dy = args["--dy"].asLong();
+
+  if (dy < 1)
+  {
+    std::cerr << "dy must be at least 1" << std::endl;
+    return 1;
+  }
+
+  int ouch = 0;
+
+  {
+    TimeScope t("Solve");
+    ouch = CountCollisions(tree_map, dx, dy);
   }
 
   std::cout << ouch << std::endl;
@@ -1,2 +1,2 @@
 #!/usr/bin/env bash
-g++ -std=c++17 -O3 main.cpp -I"../../inc" -l:libdocopt.a
+g++ -std=c++17 -O3 -pthread main.cpp -I"../../inc" -l:libdocopt.a
@@ -0,0 +1,306 @@
+#ifndef DAY03_SOLVER_INCLUDED
+#define DAY03_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "stringutil.hpp"
+#include "threadpool.hpp"
+#include "timescope.hpp"
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <future>
+#include <utility>
+
+
+namespace day03
+{
+
+
+struct Slope
+{
+  int dx;
+  int dy;
+};
+
+
+// The map with one bit per cell, set where there is a tree, as one block of
+// rows padded to whole 64-bit words. The pattern repeats to the right, so
+// the width is its period.
+class TreeMap
+{
+private:
+  size_t width = 0;
+  size_t height = 0;
+  size_t stride = 0;  // words per row
+  std::vector<uint64_t> bits;
+
+
+public:
+  TreeMap(std::string_view const buffer)
+  {
+    ForEachLine(buffer, [&](std::string_view const line)
+    {
+      if (height == 0)
+      {
+        width = line.size();
+        stride = (width + 63) / 64;
+      }
+      else if (line.size() != width)
+      {
+        std::cerr << "Row " << height + 1 << " is " << line.size() << " wide, expected " << width << std::endl;
+        exit(1);
+      }
+
+      bits.resize(bits.size() + stride);
+      uint64_t* const row = &bits[height * stride];
+
+      for (size_t x = 0; x < width; x++)
+      {
+        row[x / 64] |= static_cast<uint64_t>(line[x] == '#') << (x % 64);
+      }
+
+      height++;
+    });
+  }
+
+  size_t Width() const
+  {
+    return width;
+  }
+
+  size_t Height() const
+  {
+    return height;
+  }
+
+  // x must be less than the width
+  bool Tree(size_t const x, size_t const y) const
+  {
+    return (bits[y * stride + x / 64] >> (x % 64)) & 1;
+  }
+};
+
+
+// Collisions for each of the slopes, in one pass down the map: every row
+// is visited once, and moves on every slope which lands on it. Columns are
+// kept within the width by subtracting it, so there is no modulo per row.
+inline std::vector<int> CountCollisions(TreeMap const& tree_map, std::vector<Slope> const& slopes)
+{
+  std::vector<int> ouch(slopes.size());
+  int64_t const width = tree_map.Width();
+
+  if (width == 0)
+  {
+    return ouch;
+  }
+
+  std::vector<size_t> x(slopes.size());
+  std::vector<size_t> step(slopes.size());
+  std::vector<size_t> next_y(slopes.size());
+
+  for (size_t i = 0; i < slopes.size(); i++)
+  {
+    step[i] = ((slopes[i].dx % width) + width) % width;
+  }
+
+  for (size_t y = 0; y < tree_map.Height(); y++)
+  {
+    for (size_t i = 0; i < slopes.size(); i++)
+    {
+      if (y != next_y[i])
+      {
+        continue;
+      }
+
+      ouch[i] += tree_map.Tree(x[i], y);
+
+      x[i] += step[i];
+      x[i] -= (x[i] >= static_cast<size_t>(width)) ? width : 0;
+      next_y[i] += slopes[i].dy;
+    }
+  }
+
+  return ouch;
+}
+
+
+inline int CountCollisions(TreeMap const& tree_map, int const dx, int const dy)
+{
+  return CountCollisions(tree_map, {{dx, dy}}).front();
+}
+
+
+// "dx:dy,dx:dy,..."
+inline std::vector<Slope> ParseSlopes(std::string_view const list)
+{
+  std::vector<Slope> slopes;
+
+  for (std::string_view const item : Split(list, ','))
+  {
+    auto const [dx, dy] = SplitOnce(item, ':');
+    Slope const slope = {StringToInt(dx), StringToInt(dy)};
+
+    if (dy.empty() || slope.dy < 1)
+    {
+      std::cerr << "Expected dx:dy with dy at least 1, got '" << item << "'" << std::endl;
+      exit(1);
+    }
+
+    slopes.push_back(slope);
+  }
+
+  return slopes;
+}
+
+
+// The slopes with the fewest and most collisions among many. Ties go to the
+// smaller dy, then the smaller dx, so the answer doesn't depend on how the
+// work was split.
+struct SweepResult
+{
+  size_t slopes = 0;
+  Slope fewest = {0, 0};
+  Slope most = {0, 0};
+  int fewest_collisions = 0;
+  int most_collisions = 0;
+
+  void Add(Slope const slope, int const collisions)
+  {
+    auto const Before = [](Slope const a, Slope const b)
+    {
+      return a.dy < b.dy || (a.dy == b.dy && a.dx < b.dx);
+    };
+
+    if (slopes == 0 || collisions < fewest_collisions ||
+        (collisions == fewest_collisions && Before(slope, fewest)))
+    {
+      fewest = slope;
+      fewest_collisions = collisions;
+    }
+
+    if (slopes == 0 || collisions > most_collisions ||
+        (collisions == most_collisions && Before(slope, most)))
+    {
+      most = slope;
+      most_collisions = collisions;
+    }
+
+    slopes++;
+  }
+
+  void Add(SweepResult const& other)
+  {
+    if (other.slopes == 0)
+    {
+      return;
+    }
+
+    size_t const total = slopes + other.slopes;
+
+    Add(other.fewest, other.fewest_collisions);
+    Add(other.most, other.most_collisions);
+    slopes = total;
+  }
+};
+
+
+// Every slope with dx in [dx_min, dx_max] and dy in [dy_min, dy_max], on a
+// pool of threads (0 for one per core). Each task takes up to SWEEP_GROUP
+// slopes with the same dy, counts them in one pass down the map and keeps
+// its own result, and the results are merged at the end.
+inline SweepResult SweepSlopes(
+  TreeMap const& tree_map,
+  int const dx_min, int const dx_max,
+  int const dy_min, int const dy_max,
+  unsigned const threads)
+{
+  size_t const SWEEP_GROUP = 64;
+
+  ThreadPool pool(threads);
+  std::vector<std::future<SweepResult>> groups;
+
+  for (int dy = dy_min; dy <= dy_max; dy++)
+  {
+    for (int64_t dx = dx_min; dx <= dx_max; dx += SWEEP_GROUP)
+    {
+      std::vector<Slope> slopes;
+
+      for (int64_t i = dx; i <= dx_max && slopes.size() < SWEEP_GROUP; i++)
+      {
+        slopes.push_back({static_cast<int>(i), dy});
+      }
+
+      groups.push_back(pool.Submit([&tree_map, slopes = std::move(slopes)]
+      {
+        std::vector<int> const ouch = CountCollisions(tree_map, slopes);
+        SweepResult result;
+
+        for (size_t i = 0; i < slopes.size(); i++)
+        {
+          result.Add(slopes[i], ouch[i]);
+        }
+
+        return result;
+      }));
+    }
+  }
+
+  SweepResult result;
+
+  for (std::future<SweepResult>& group : groups)
+  {
+    result.Add(group.get());
+  }
+
+  return result;
+}
+
+
+// "min..max", a single number is a range of one
+inline std::pair<int, int> ParseRange(std::string_view const range)
+{
+  auto const [min, max] = SplitOnce(range, "..");
+  std::pair<int, int> const parsed = {StringToInt(min), StringToInt(max.empty() ? min : max)};
+
+  if (parsed.first > parsed.second)
+  {
+    std::cerr << "Range '" << range << "' is empty" << std::endl;
+    exit(1);
+  }
+
+  return parsed;
+}
+
+
+// Part one is the default slope, part two the product over the listed slopes
+inline std::string Solve(std::string_view const input)
+{
+  TreeMap const tree_map(input);
+  std::stringstream ss;
+
+  std::vector<Slope> const slopes = {{3, 1}, {1, 1}, {5, 1}, {7, 1}, {1, 2}};
+  std::vector<int> const ouch = CountCollisions(tree_map, slopes);
+
+  ss << "slope (3, 1): " << ouch[0] << std::endl;
+
+  int64_t product = 1;
+
+  for (int const count : ouch)
+  {
+    product *= count;
+  }
+
+  ss << "slope product: " << product << std::endl;
+
+  return ss.str();
+}
+
+
+} // namespace day03
+
+
+#endif // DAY03_SOLVER_INCLUDED
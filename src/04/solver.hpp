@@ -0,0 +1,461 @@
+#ifndef DAY04_SOLVER_INCLUDED
+#define DAY04_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "stringutil.hpp"
+#include "threadpool.hpp"
+#include "timescope.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iostream>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <future>
+
+
+namespace day04
+{
+
+
+using namespace std;
+
+
+// The fields which are checked, cid is ignored
+enum Field
+{
+  BIRTH_YEAR,
+  ISSUE_YEAR,
+  EXPIRATION_YEAR,
+  HEIGHT,
+  HAIR_COLOUR,
+  EYE_COLOUR,
+  PASSPORT_ID,
+  FIELD_COUNT
+};
+
+unsigned const REQUIRED_FIELDS = (1u << FIELD_COUNT) - 1;
+
+
+// Values are views into the input, which must outlive the passport. A bit
+// in present is set for each field seen; if one is repeated, the last wins.
+struct Passport
+{
+  array<string_view, FIELD_COUNT> fields;
+  unsigned present = 0;
+
+  string_view operator[](Field const field) const
+  {
+    return fields[field];
+  }
+};
+
+
+// FIELD_COUNT for keys which aren't checked
+inline Field FieldFromKey(string_view const key)
+{
+  if (key.size() != 3)
+  {
+    return FIELD_COUNT;
+  }
+
+  switch ((key[0] << 16) | (key[1] << 8) | key[2])
+  {
+    case ('b' << 16) | ('y' << 8) | 'r': return BIRTH_YEAR;
+    case ('i' << 16) | ('y' << 8) | 'r': return ISSUE_YEAR;
+    case ('e' << 16) | ('y' << 8) | 'r': return EXPIRATION_YEAR;
+    case ('h' << 16) | ('g' << 8) | 't': return HEIGHT;
+    case ('h' << 16) | ('c' << 8) | 'l': return HAIR_COLOUR;
+    case ('e' << 16) | ('c' << 8) | 'l': return EYE_COLOUR;
+    case ('p' << 16) | ('i' << 8) | 'd': return PASSPORT_ID;
+    default: return FIELD_COUNT;
+  }
+}
+
+
+// Passports are separated by blank lines
+inline vector<Passport> PassportList(string_view const input)
+{
+  vector<Passport> passports(1);
+
+  ForEachLine(input, [&](string_view const line)
+  {
+    if (line == "")
+    {
+      passports.push_back(Passport());
+      return;
+    }
+
+    for (auto const token : Split(line, ' '))
+    {
+      auto const [key, value] = SplitOnce(token, ':');
+      Field const field = FieldFromKey(key);
+
+      if (field != FIELD_COUNT)
+      {
+        passports.back().fields[field] = value;
+        passports.back().present |= 1u << field;
+      }
+    }
+  });
+
+  return passports;
+}
+
+
+inline bool HasRequiredFields(Passport const& passport)
+{
+  return passport.present == REQUIRED_FIELDS;
+}
+
+
+// Character classes, looked up rather than searched for
+enum CharClass : uint8_t
+{
+  DIGIT = 1,
+  HEX = 2  // lower case only
+};
+
+
+constexpr array<uint8_t, 256> MakeCharClasses()
+{
+  array<uint8_t, 256> classes = {};
+
+  for (int c = '0'; c <= '9'; c++)
+  {
+    classes[c] = DIGIT | HEX;
+  }
+
+  for (int c = 'a'; c <= 'f'; c++)
+  {
+    classes[c] = HEX;
+  }
+
+  return classes;
+}
+
+
+constexpr array<uint8_t, 256> char_classes = MakeCharClasses();
+
+
+// True if every character is in the class. Sums the misses rather than
+// stopping at the first, so there's no branch per character.
+inline bool AllOfClass(string_view const str, uint8_t const char_class)
+{
+  unsigned misses = 0;
+
+  for (char const c : str)
+  {
+    misses += (char_classes[static_cast<uint8_t>(c)] & char_class) == 0;
+  }
+
+  return misses == 0;
+}
+
+
+// Exactly four digits, between min and max
+inline bool IntegerValueBetween(
+  Passport const& passport,
+  Field const field,
+  int const min,
+  int const max)
+{
+  string_view const value = passport[field];
+
+  if (value.size() != 4 || !AllOfClass(value, DIGIT))
+  {
+    return false;
+  }
+
+  int const i = (value[0] - '0') * 1000 + (value[1] - '0') * 100 + (value[2] - '0') * 10 + (value[3] - '0');
+  return i >= min && i <= max;
+}
+
+
+// A number (with an optional '+', as stream extraction takes) then cm or in
+inline bool HeightValid(Passport const& passport)
+{
+  string_view value = passport[HEIGHT];
+
+  if (value.size() < 3)
+  {
+    return false;
+  }
+
+  string_view const units = value.substr(value.size() - 2);
+  value = value.substr(value[0] == '+', value.size() - 2 - (value[0] == '+'));
+
+  if (value.empty() || !AllOfClass(value, DIGIT))
+  {
+    return false;
+  }
+
+  // Anything over four digits (leading zeros aside) is out of range anyway
+  int height = 0;
+
+  for (char const c : value)
+  {
+    height = min(height * 10 + (c - '0'), 10000);
+  }
+
+  if (units == "cm")
+  {
+    return height >= 150 && height <= 193;
+  }
+  else if (units == "in")
+  {
+    return height >= 59 && height <= 76;
+  }
+
+  return false;
+}
+
+
+inline bool HairColourValid(Passport const& passport)
+{
+  string_view const colour_str = passport[HAIR_COLOUR];
+  return colour_str.size() == 7 && colour_str[0] == '#' && AllOfClass(colour_str.substr(1), HEX);
+}
+
+
+// The seven colours packed into integers hash to distinct slots with this
+// multiplier, so one compare against the slot decides
+uint32_t const EYE_COLOUR_MULTIPLIER = 0xea90a8f1;
+
+
+constexpr uint32_t PackColour(char const a, char const b, char const c)
+{
+  return static_cast<uint8_t>(a) | (static_cast<uint8_t>(b) << 8) | (static_cast<uint8_t>(c) << 16);
+}
+
+
+constexpr uint32_t EyeColourSlot(uint32_t const packed)
+{
+  return (packed * EYE_COLOUR_MULTIPLIER) >> 29;
+}
+
+
+constexpr array<uint32_t, 8> MakeEyeColourTable()
+{
+  // Not a packed colour, for the unused slot
+  array<uint32_t, 8> table = {UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX,
+                              UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX};
+
+  char const colours[][4] = {"amb", "blu", "brn", "gry", "grn", "hzl", "oth"};
+
+  for (auto const& colour : colours)
+  {
+    uint32_t const packed = PackColour(colour[0], colour[1], colour[2]);
+    table[EyeColourSlot(packed)] = packed;
+  }
+
+  return table;
+}
+
+
+constexpr array<uint32_t, 8> eye_colours = MakeEyeColourTable();
+
+
+inline bool EyeColourValid(Passport const& passport)
+{
+  string_view const colour = passport[EYE_COLOUR];
+
+  if (colour.size() != 3)
+  {
+    return false;
+  }
+
+  uint32_t const packed = PackColour(colour[0], colour[1], colour[2]);
+  return eye_colours[EyeColourSlot(packed)] == packed;
+}
+
+
+inline bool PassportIDValid(Passport const& passport)
+{
+  string_view const id_str = passport[PASSPORT_ID];
+  return id_str.size() == 9 && AllOfClass(id_str, DIGIT);
+}
+
+
+// Every check is made and the results combined with &, rather than
+// stopping at the first failure. Missing fields are empty, and fail.
+inline bool IsValid(Passport const& passport, bool const do_detailed_check)
+{
+  if (!do_detailed_check)
+  {
+    return HasRequiredFields(passport);
+  }
+
+  return HasRequiredFields(passport) &
+         IntegerValueBetween(passport, BIRTH_YEAR, 1920, 2002) &
+         IntegerValueBetween(passport, ISSUE_YEAR, 2010, 2020) &
+         IntegerValueBetween(passport, EXPIRATION_YEAR, 2020, 2030) &
+         HeightValid(passport) &
+         HairColourValid(passport) &
+         EyeColourValid(passport) &
+         PassportIDValid(passport);
+}
+
+
+// Checks count passports from first, setting valid[i] to 1 or 0 for each
+// (unless valid is null), and returns how many passed
+inline size_t ValidateBatch(
+  Passport const* const first,
+  size_t const count,
+  bool const do_detailed_check,
+  uint8_t* const valid = nullptr)
+{
+  size_t passed = 0;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    bool const ok = IsValid(first[i], do_detailed_check);
+
+    if (valid != nullptr)
+    {
+      valid[i] = ok;
+    }
+
+    passed += ok;
+  }
+
+  return passed;
+}
+
+
+inline int CountValid(vector<Passport> const& passports, bool const do_detailed_check)
+{
+  return ValidateBatch(passports.data(), passports.size(), do_detailed_check);
+}
+
+
+// Cuts the input at about equal byte offsets, each moved on to the start of
+// the next blank line so that no passport is split between pieces. A piece
+// may then begin with the blank line, which only adds an empty passport.
+inline vector<string_view> SplitAtRecords(string_view const input, size_t const pieces)
+{
+  vector<string_view> chunks;
+  size_t start = 0;
+
+  for (size_t k = 1; k <= pieces && start < input.size(); k++)
+  {
+    size_t end = input.size();
+
+    if (k < pieces)
+    {
+      size_t const cut = max(start, input.size() / pieces * k);
+      size_t const blank = input.find("\n\n", cut > 0 ? cut - 1 : 0);
+
+      end = (blank == string_view::npos) ? input.size() : blank + 1;
+    }
+
+    if (end > start)
+    {
+      chunks.push_back(input.substr(start, end - start));
+    }
+
+    start = end;
+  }
+
+  return chunks;
+}
+
+
+// Every passport in the input, in order. Pieces of the input (see
+// SplitAtRecords) are parsed on a pool of threads (0 for one per core), and
+// joined in order, so the list is the same as reading the input in one go.
+inline vector<Passport> ParsePassports(string_view const input, unsigned const threads)
+{
+  if (threads == 1)
+  {
+    return PassportList(input);
+  }
+
+  ThreadPool pool(threads);
+  vector<future<vector<Passport>>> pieces;
+
+  for (string_view const chunk : SplitAtRecords(input, pool.Size() * 4))
+  {
+    pieces.push_back(pool.Submit([chunk] { return PassportList(chunk); }));
+  }
+
+  vector<Passport> passports;
+
+  for (future<vector<Passport>>& piece : pieces)
+  {
+    vector<Passport> const part = piece.get();
+    passports.insert(passports.end(), part.begin(), part.end());
+  }
+
+  return passports;
+}
+
+
+// The passports which pass, in input order. Equal runs of passports are
+// checked on a pool of threads (0 for one per core).
+inline vector<Passport> ValidPassports(vector<Passport> const& passports, bool const do_detailed_check, unsigned const threads)
+{
+  vector<uint8_t> valid(passports.size());
+
+  auto const Check = [&](size_t const first, size_t const last)
+  {
+    ValidateBatch(passports.data() + first, last - first, do_detailed_check, valid.data() + first);
+  };
+
+  if (threads == 1)
+  {
+    Check(0, passports.size());
+  }
+  else
+  {
+    ThreadPool pool(threads);
+    vector<future<void>> pieces;
+    size_t const count = pool.Size() * 4;
+
+    for (size_t i = 0; i < count; i++)
+    {
+      size_t const first = passports.size() * i / count;
+      size_t const last = passports.size() * (i + 1) / count;
+
+      pieces.push_back(pool.Submit([&Check, first, last] { Check(first, last); }));
+    }
+
+    for (future<void>& piece : pieces)
+    {
+      piece.get();
+    }
+  }
+
+  vector<Passport> passed;
+
+  for (size_t i = 0; i < passports.size(); i++)
+  {
+    if (valid[i])
+    {
+      passed.push_back(passports[i]);
+    }
+  }
+
+  return passed;
+}
+
+
+inline string Solve(string_view const input)
+{
+  vector<Passport> const passports = PassportList(input);
+  stringstream ss;
+
+  ss << "required fields: " << CountValid(passports, false) << endl;
+  ss << "detailed check: " << CountValid(passports, true) << endl;
+
+  return ss.str();
+}
+
+
+} // namespace day04
+
+
+#endif // DAY04_SOLVER_INCLUDED
@@ -0,0 +1,86 @@
+#include "../assembler.hpp"
+#include "../image.hpp"
+
+#include "mappedfile.hpp"
+#include "timescope.hpp"
+
+#include "docopt/docopt.h"
+
+#include <string>
+#include <fstream>
+#include <iostream>
+
+
+using namespace day05;
+
+
+static const char USAGE[] =
+R"(Day 05 assembler v1.0.
+
+Assembles programs for cpu.circ the same way asm.py does, from the same
+instruction table as the emulator: one instruction per line, "label:" lines,
+and ';' comment lines. Registers are r0-r15, lr and sp. Immediates are
+decimal, hex after 0x, or a label, which for jumps and calls is relative to
+the instruction.
+
+Each program is written as a Logisim "v2.0 raw" image, or with --binary as
+little-endian 32-bit words, which the emulator loads too. Unless --output is
+given, the image goes next to its source with the extension .hex (or .bin).
+
+Usage:
+  a.out [options] <input-file>...
+  a.out (-h | --help)
+
+Options:
+  -h --help            Print this help message.
+  -o --output <file>   Path to output the assembled code to, with one input.
+  -b --binary          Write a binary image instead of a hex one.
+  -l --labels          Print the address of every label.
+)";
+
+
+int main(int argc, char **argv)
+{
+  auto args = docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
+
+  std::vector<std::string> const inputs = args["<input-file>"].asStringList();
+  bool const binary = args["--binary"].asBool();
+
+  if (args["--output"] && inputs.size() != 1)
+  {
+    std::cerr << "--output needs exactly one input" << std::endl;
+    return 1;
+  }
+
+  for (std::string const& input : inputs)
+  {
+    MappedFile const file(input);
+    std::string const output = args["--output"] ? args["--output"].asString() : ImagePath(input, binary);
+    std::string image;
+
+    {
+      TimeScope t("Assemble");
+      Program const program = Assemble(file.View(), input);
+
+      if (args["--labels"].asBool())
+      {
+        for (auto const& [label, address] : program.labels)
+        {
+          std::cout << label << ":\t" << address << std::endl;
+        }
+      }
+
+      image = binary ? FormatBinary(program.words) : FormatImage(program.words);
+    }
+
+    std::ofstream ofs(output, std::ios::binary);
+
+    if (!ofs.write(image.data(), image.size()))
+    {
+      std::cerr << "Could not write " << output << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,219 @@
+#ifndef DAY05_ASSEMBLER_INCLUDED
+#define DAY05_ASSEMBLER_INCLUDED
+
+#include "isa.hpp"
+
+#include "loadlines.hpp"
+#include "stringutil.hpp"
+
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <charconv>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+
+namespace day05
+{
+
+
+struct Program
+{
+  std::vector<uint32_t> words;
+  std::vector<std::pair<std::string_view, uint32_t>> labels;  // in the order they are defined
+};
+
+
+[[noreturn]] inline void AssemblyError(
+  std::string_view const name,
+  size_t const line_number,
+  std::string_view const line,
+  std::string_view const message)
+{
+  std::cerr << name << ":" << line_number << ": " << message << std::endl;
+  std::cerr << "  " << line << std::endl;
+  exit(1);
+}
+
+
+// Decimal with an optional sign, or hex after "0x", as Python's int() reads
+// them in asm.py. False if the token isn't a number.
+inline bool ParseImmediate(std::string_view const token, int64_t& value)
+{
+  char const* begin = token.data();
+  char const* const end = begin + token.size();
+  int base = 10;
+
+  if (token.substr(0, 2) == "0x")
+  {
+    begin += 2;
+    base = 16;
+  }
+  else if (token.substr(0, 1) == "+")
+  {
+    begin++;
+  }
+
+  // from_chars takes a '-' in either base, Python only before decimal digits
+  if (begin == end || *begin == '+' || (*begin == '-' && (base == 16 || token[0] == '+')))
+  {
+    return false;
+  }
+
+  auto const [ptr, error] = std::from_chars(begin, end, value, base);
+
+  return error == std::errc() && ptr == end;
+}
+
+
+// Assembles source the way asm.py does: one instruction per line, labels
+// are lines ending in ':', and lines starting with ';' are comments. An
+// immediate may be a label, which for jumps and calls is relative to the
+// instruction. Errors stop with the line they are on, as in asm.py.
+inline Program Assemble(std::string_view const source, std::string_view const name)
+{
+  struct SourceLine
+  {
+    std::string_view text;
+    size_t number;
+  };
+
+  Program program;
+  std::unordered_map<std::string_view, uint32_t> labels;
+  std::vector<SourceLine> instructions;
+  size_t line_number = 0;
+
+  // First pass, finds where the labels are
+  ForEachLine(source, [&](std::string_view const raw)
+  {
+    std::string_view const line = trim(raw);
+    line_number++;
+
+    if (line.empty() || line[0] == ';')
+    {
+      return;
+    }
+
+    if (line.back() == ':')
+    {
+      size_t const start = line.find_first_not_of(':');
+      size_t const end = line.find_last_not_of(':');
+      std::string_view const label = (start == std::string_view::npos) ? "" : trim(line.substr(start, end - start + 1));
+
+      if (!labels.emplace(label, instructions.size()).second)
+      {
+        AssemblyError(name, line_number, line, "Duplicate label '" + std::string(label) + "'");
+      }
+
+      program.labels.emplace_back(label, instructions.size());
+      return;
+    }
+
+    instructions.push_back({line, line_number});
+  });
+
+  // Second pass, assembles the instructions
+  program.words.reserve(instructions.size());
+
+  for (uint32_t index = 0; index < instructions.size(); index++)
+  {
+    auto const [line, number] = instructions[index];
+
+    auto const Error = [&, line = line, number = number](std::string const& message)
+    {
+      AssemblyError(name, number, line, message);
+    };
+
+    size_t const MAX_TOKENS = 4;
+    std::string_view tokens[MAX_TOKENS + 1];
+    size_t count = 0;
+
+    for (size_t pos = 0; count <= MAX_TOKENS;)
+    {
+      pos = line.find_first_not_of(WHITESPACE, pos);
+
+      if (pos == std::string_view::npos)
+      {
+        break;
+      }
+
+      size_t const end = std::min(line.find_first_of(WHITESPACE, pos), line.size());
+      tokens[count++] = line.substr(pos, end - pos);
+      pos = end;
+    }
+
+    InstructionDefinition const* const definition = FindInstruction(tokens[0]);
+
+    if (definition == nullptr)
+    {
+      Error("No such instruction '" + std::string(tokens[0]) + "'");
+    }
+
+    std::vector<Field> const& fields = FormatFields(definition->format);
+
+    if (count != fields.size())
+    {
+      Error("Incorrect number of tokens. " + std::string(definition->mnemonic) +
+        " expects " + std::to_string(fields.size()) + " tokens.");
+    }
+
+    uint32_t word = 0;
+
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+      Field const& field = fields[i];
+      std::string_view const token = tokens[i];
+      int64_t value = 0;
+
+      if (field.type == FieldType::OPCODE)
+      {
+        value = definition->opcode;
+      }
+      else if (field.type == FieldType::IMMEDIATE)
+      {
+        if (!ParseImmediate(token, value))
+        {
+          auto const label = labels.find(token);
+
+          if (label == labels.end())
+          {
+            Error("No such label '" + std::string(token) + "'");
+          }
+
+          value = static_cast<int64_t>(label->second) - (definition->relative_immediates ? index : 0);
+        }
+      }
+      else
+      {
+        value = RegisterIndex(token);
+
+        if (value < 0)
+        {
+          Error("No such register '" + std::string(token) + "'");
+        }
+      }
+
+      if (!field.Fits(value))
+      {
+        Error("Field value " + std::to_string(value) + " out of range.");
+      }
+
+      word = field.Insert(word, value);
+    }
+
+    program.words.push_back(word);
+  }
+
+  return program;
+}
+
+
+} // namespace day05
+
+
+#endif // DAY05_ASSEMBLER_INCLUDED
@@ -0,0 +1,595 @@
+#ifndef DAY05_CPU_INCLUDED
+#define DAY05_CPU_INCLUDED
+
+#include "isa.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <utility>
+
+
+namespace day05
+{
+
+
+// An emulation of cpu.circ: sixteen 32-bit registers, a program ROM of
+// words addressed by instruction, and a byte addressed, little-endian RAM.
+// Reading past the end of the program gives zero, which is HLT, just as an
+// empty ROM cell does in Logisim.
+//
+// There are two engines which give the same results: a plain switch over
+// the opcode of each word as it is fetched, and threaded code, where the ROM
+// is decoded once and each handler jumps straight to the next.
+class Cpu
+{
+public:
+  static size_t const DEFAULT_RAM_SIZE = 1 << 16;
+
+  enum class Status
+  {
+    HALTED,
+    STEP_LIMIT
+  };
+
+  enum class Engine
+  {
+    SWITCH,
+    THREADED
+  };
+
+
+private:
+  // An instruction with its fields extracted and its immediate extended the
+  // way its opcode uses it. Jumps and calls hold the index of their target
+  // in the decoded code instead, HLT the address it is at.
+  struct Decoded
+  {
+    void const* handler;
+    uint32_t immediate;
+    uint8_t a;
+    uint8_t b;
+    uint8_t c;
+  };
+
+  std::vector<uint32_t> rom;
+  std::vector<Decoded> code;  // decoded on the first threaded run
+  std::vector<uint8_t> ram;
+  uint32_t ram_mask;
+
+  std::array<uint32_t, REGISTER_COUNT> registers = {};
+  uint32_t pc = 0;
+  uint64_t steps = 0;
+
+  // From the last ALU operation or CMP, greater is neither
+  bool zero = false;
+  bool negative = false;
+
+
+  [[noreturn]] void Illegal(uint32_t const word) const
+  {
+    std::cerr << "Illegal instruction 0x" << std::hex << word << " at 0x" << pc << std::dec << std::endl;
+    exit(1);
+  }
+
+  // Addresses wrap at the end of the RAM, as the address bus is only as wide
+  // as it needs to be. A word starting in the last three bytes wraps a byte
+  // at a time.
+  uint32_t Load32(uint32_t address) const
+  {
+    address &= ram_mask;
+
+    if (address <= ram_mask - 3)
+    {
+      uint8_t const* const p = &ram[address];
+      return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    uint32_t word = 0;
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+      word |= static_cast<uint32_t>(ram[(address + i) & ram_mask]) << (i * 8);
+    }
+
+    return word;
+  }
+
+  void Store32(uint32_t const address, uint32_t const word)
+  {
+    for (uint32_t i = 0; i < 4; i++)
+    {
+      ram[(address + i) & ram_mask] = word >> (i * 8);
+    }
+  }
+
+  void SetFlags(uint32_t const result)
+  {
+    zero = (result == 0);
+    negative = (result >> 31);
+  }
+
+
+  // Fetches, decodes and dispatches one word at a time
+  Status RunSwitch(uint64_t const max_steps)
+  {
+    uint32_t* const r = registers.data();
+    uint64_t const limit = steps + max_steps;
+
+    while (steps < limit)
+    {
+      uint32_t const word = (pc < rom.size()) ? rom[pc] : 0;
+      uint32_t const a = REGISTER_A.Extract(word);
+      uint32_t const b = REGISTER_B.Extract(word);
+      uint32_t const c = REGISTER_C.Extract(word);
+
+      steps++;
+
+      switch (OPCODE_FIELD.Extract(word))
+      {
+        case HLT:
+          return Status::HALTED;
+
+        case MOVI:
+          r[c] = IMMEDIATE_16.ExtractSigned(word);
+          break;
+
+        case MOVIL:
+          r[c] = (r[c] & 0xffff0000) | IMMEDIATE_16.Extract(word);
+          break;
+
+        case MOVIH:
+          r[c] = (r[c] & 0x0000ffff) | (IMMEDIATE_16.Extract(word) << 16);
+          break;
+
+        case MOV:
+          r[c] = r[a];
+          break;
+
+        case ADD:
+          r[c] = r[a] + r[b];
+          SetFlags(r[c]);
+          break;
+
+        case ADDI:
+          r[c] = r[a] + IMMEDIATE_8.Extract(word);
+          SetFlags(r[c]);
+          break;
+
+        case SUB:
+          r[c] = r[a] - r[b];
+          SetFlags(r[c]);
+          break;
+
+        case SUBI:
+          r[c] = r[a] - IMMEDIATE_8.Extract(word);
+          SetFlags(r[c]);
+          break;
+
+        case CMP:
+          SetFlags(r[a] - r[b]);
+          break;
+
+        case JMP:
+          pc += IMMEDIATE_24.ExtractSigned(word);
+          continue;
+
+        case JMPZ:
+          pc += zero ? IMMEDIATE_24.ExtractSigned(word) : 1;
+          continue;
+
+        case JMPNZ:
+          pc += !zero ? IMMEDIATE_24.ExtractSigned(word) : 1;
+          continue;
+
+        case JMPLZ:
+          pc += negative ? IMMEDIATE_24.ExtractSigned(word) : 1;
+          continue;
+
+        case JMPGZ:
+          pc += (!zero && !negative) ? IMMEDIATE_24.ExtractSigned(word) : 1;
+          continue;
+
+        case LD32:
+          r[c] = Load32(r[a] + IMMEDIATE_8.ExtractSigned(word));
+          break;
+
+        case LD8:
+          r[c] = ram[(r[a] + IMMEDIATE_8.ExtractSigned(word)) & ram_mask];
+          break;
+
+        case LD8S:
+          r[c] = static_cast<int8_t>(ram[(r[a] + IMMEDIATE_8.ExtractSigned(word)) & ram_mask]);
+          break;
+
+        case ST32:
+          Store32(r[a] + IMMEDIATE_8.ExtractSigned(word), r[c]);
+          break;
+
+        case CALL:
+          for (int i = FIRST_SAVED_REGISTER; i <= LAST_SAVED_REGISTER; i++)
+          {
+            Store32(r[STACK_POINTER], r[i]);
+            r[STACK_POINTER] -= 4;
+          }
+
+          r[LINK_REGISTER] = pc + 1;
+          pc += IMMEDIATE_24.ExtractSigned(word);
+          continue;
+
+        case RET:
+          pc = r[LINK_REGISTER];
+
+          for (int i = LAST_SAVED_REGISTER; i >= FIRST_SAVED_REGISTER; i--)
+          {
+            r[STACK_POINTER] += 4;
+            r[i] = Load32(r[STACK_POINTER]);
+          }
+
+          continue;
+
+        default:
+          Illegal(word);
+      }
+
+      pc++;
+    }
+
+    return Status::STEP_LIMIT;
+  }
+
+
+  // Decodes the ROM for the threaded engine. After the ROM comes a HLT for
+  // running off its end, then one for each jump target outside it, so that
+  // every jump lands on a decoded instruction.
+  void Decode(void const* const* const handlers)
+  {
+    std::map<uint32_t, uint32_t> outside;  // target address -> index in code
+
+    auto const Target = [&](uint32_t const address) -> uint32_t
+    {
+      if (address < rom.size())
+      {
+        return address;
+      }
+
+      return outside.emplace(address, rom.size() + 1 + outside.size()).first->second;
+    };
+
+    code.resize(rom.size() + 1);
+
+    for (uint32_t i = 0; i < rom.size(); i++)
+    {
+      uint32_t const word = rom[i];
+      uint8_t const opcode = OPCODE_FIELD.Extract(word);
+      uint32_t immediate = 0;
+
+      switch (opcode)
+      {
+        case HLT:
+          immediate = i;
+          break;
+
+        case MOVI:
+          immediate = IMMEDIATE_16.ExtractSigned(word);
+          break;
+
+        case MOVIL:
+          immediate = IMMEDIATE_16.Extract(word);
+          break;
+
+        case MOVIH:
+          immediate = IMMEDIATE_16.Extract(word) << 16;
+          break;
+
+        case ADDI:
+        case SUBI:
+          immediate = IMMEDIATE_8.Extract(word);
+          break;
+
+        case LD32:
+        case LD8:
+        case LD8S:
+        case ST32:
+          immediate = IMMEDIATE_8.ExtractSigned(word);
+          break;
+
+        case JMP:
+        case JMPZ:
+        case JMPNZ:
+        case JMPLZ:
+        case JMPGZ:
+        case CALL:
+          immediate = Target(i + IMMEDIATE_24.ExtractSigned(word));
+          break;
+      }
+
+      code[i] = {
+        handlers[opcode],
+        immediate,
+        static_cast<uint8_t>(REGISTER_A.Extract(word)),
+        static_cast<uint8_t>(REGISTER_B.Extract(word)),
+        static_cast<uint8_t>(REGISTER_C.Extract(word))
+      };
+    }
+
+    code[rom.size()] = {handlers[HLT], static_cast<uint32_t>(rom.size()), 0, 0, 0};
+    code.resize(rom.size() + 1 + outside.size());
+
+    for (auto const [address, index] : outside)
+    {
+      code[index] = {handlers[HLT], address, 0, 0, 0};
+    }
+  }
+
+  // Threaded code: the decoded instructions hold the address of their
+  // handler, and each handler ends by jumping to the next one's, so there
+  // is no central dispatch and nothing left to extract. The flags are kept
+  // as the last result, which the conditional jumps test directly. Labels
+  // as values are a GNU extension, other compilers get the switch.
+  Status RunThreaded(uint64_t const max_steps)
+  {
+#if defined(__GNUC__)
+    void const* handlers[256];
+
+    std::fill(std::begin(handlers), std::end(handlers), &&illegal);
+    handlers[HLT] = &&hlt;
+    handlers[MOVI] = &&movi;
+    handlers[MOVIL] = &&movil;
+    handlers[MOVIH] = &&movih;
+    handlers[MOV] = &&mov;
+    handlers[ADD] = &&add;
+    handlers[ADDI] = &&addi;
+    handlers[SUB] = &&sub;
+    handlers[SUBI] = &&subi;
+    handlers[CMP] = &&cmp;
+    handlers[JMP] = &&jmp;
+    handlers[JMPZ] = &&jmpz;
+    handlers[JMPNZ] = &&jmpnz;
+    handlers[JMPLZ] = &&jmplz;
+    handlers[JMPGZ] = &&jmpgz;
+    handlers[LD32] = &&ld32;
+    handlers[LD8] = &&ld8;
+    handlers[LD8S] = &&ld8s;
+    handlers[ST32] = &&st32;
+    handlers[CALL] = &&call;
+    handlers[RET] = &&ret;
+
+    if (code.empty())
+    {
+      Decode(handlers);
+    }
+
+    // Off the end of the program, where there is only HLT
+    if (pc >= rom.size())
+    {
+      return RunSwitch(max_steps);
+    }
+
+    uint32_t* const r = registers.data();
+    uint8_t* const memory = ram.data();
+    Decoded const* const base = code.data();
+    Decoded const* ip = base + pc;
+    uint64_t budget = max_steps;
+    uint32_t result = zero ? 0 : (negative ? 0x80000000 : 1);
+    uint32_t target = 0;
+    Status status = Status::HALTED;
+
+#define DAY05_DISPATCH() do { if (budget == 0) goto out_of_steps; budget--; goto *ip->handler; } while (false)
+#define DAY05_NEXT() do { ip++; DAY05_DISPATCH(); } while (false)
+
+    DAY05_DISPATCH();
+
+  hlt:
+    pc = ip->immediate;
+    goto done;
+
+  movi:
+    r[ip->c] = ip->immediate;
+    DAY05_NEXT();
+
+  movil:
+    r[ip->c] = (r[ip->c] & 0xffff0000) | ip->immediate;
+    DAY05_NEXT();
+
+  movih:
+    r[ip->c] = (r[ip->c] & 0x0000ffff) | ip->immediate;
+    DAY05_NEXT();
+
+  mov:
+    r[ip->c] = r[ip->a];
+    DAY05_NEXT();
+
+  add:
+    result = r[ip->c] = r[ip->a] + r[ip->b];
+    DAY05_NEXT();
+
+  addi:
+    result = r[ip->c] = r[ip->a] + ip->immediate;
+    DAY05_NEXT();
+
+  sub:
+    result = r[ip->c] = r[ip->a] - r[ip->b];
+    DAY05_NEXT();
+
+  subi:
+    result = r[ip->c] = r[ip->a] - ip->immediate;
+    DAY05_NEXT();
+
+  cmp:
+    result = r[ip->a] - r[ip->b];
+    DAY05_NEXT();
+
+  jmp:
+    ip = base + ip->immediate;
+    DAY05_DISPATCH();
+
+  jmpz:
+    ip = (result == 0) ? base + ip->immediate : ip + 1;
+    DAY05_DISPATCH();
+
+  jmpnz:
+    ip = (result != 0) ? base + ip->immediate : ip + 1;
+    DAY05_DISPATCH();
+
+  jmplz:
+    ip = (static_cast<int32_t>(result) < 0) ? base + ip->immediate : ip + 1;
+    DAY05_DISPATCH();
+
+  jmpgz:
+    ip = (static_cast<int32_t>(result) > 0) ? base + ip->immediate : ip + 1;
+    DAY05_DISPATCH();
+
+  ld32:
+    r[ip->c] = Load32(r[ip->a] + ip->immediate);
+    DAY05_NEXT();
+
+  ld8:
+    r[ip->c] = memory[(r[ip->a] + ip->immediate) & ram_mask];
+    DAY05_NEXT();
+
+  ld8s:
+    r[ip->c] = static_cast<int8_t>(memory[(r[ip->a] + ip->immediate) & ram_mask]);
+    DAY05_NEXT();
+
+  st32:
+    Store32(r[ip->a] + ip->immediate, r[ip->c]);
+    DAY05_NEXT();
+
+  call:
+    for (int i = FIRST_SAVED_REGISTER; i <= LAST_SAVED_REGISTER; i++)
+    {
+      Store32(r[STACK_POINTER], r[i]);
+      r[STACK_POINTER] -= 4;
+    }
+
+    r[LINK_REGISTER] = (ip - base) + 1;
+    ip = base + ip->immediate;
+    DAY05_DISPATCH();
+
+  ret:
+    target = r[LINK_REGISTER];
+
+    for (int i = LAST_SAVED_REGISTER; i >= FIRST_SAVED_REGISTER; i--)
+    {
+      r[STACK_POINTER] += 4;
+      r[i] = Load32(r[STACK_POINTER]);
+    }
+
+    if (target < rom.size())
+    {
+      ip = base + target;
+      DAY05_DISPATCH();
+    }
+
+    // Returned out of the program, to a HLT there is no code for
+    pc = target;
+    status = (budget == 0) ? Status::STEP_LIMIT : Status::HALTED;
+    budget -= (budget != 0);
+    goto done;
+
+  illegal:
+    pc = ip - base;
+    Illegal(rom[pc]);
+
+  out_of_steps:
+    // Past the ROM is HLT, which holds its own address
+    pc = (static_cast<size_t>(ip - base) < rom.size()) ? ip - base : ip->immediate;
+    status = Status::STEP_LIMIT;
+
+  done:
+    steps += max_steps - budget;
+    zero = (result == 0);
+    negative = (result >> 31);
+
+    return status;
+
+#undef DAY05_DISPATCH
+#undef DAY05_NEXT
+#else
+    return RunSwitch(max_steps);
+#endif
+  }
+
+
+public:
+  Cpu(std::vector<uint32_t> program, size_t const ram_size = DEFAULT_RAM_SIZE) :
+    rom(std::move(program)),
+    ram(ram_size),
+    ram_mask(ram_size - 1)
+  {
+    if (ram_size < 4 || ram_size > (size_t(1) << 32) || (ram_size & (ram_size - 1)) != 0)
+    {
+      std::cerr << "RAM size must be a power of two from 4 bytes to 4GiB, not " << ram_size << std::endl;
+      exit(1);
+    }
+  }
+
+  // Copies bytes into the RAM from address on
+  void LoadRam(std::string_view const bytes, size_t const address = 0)
+  {
+    if (address > ram.size() || bytes.size() > ram.size() - address)
+    {
+      std::cerr << "Can't fit " << bytes.size() << " bytes in RAM at 0x" << std::hex << address << std::dec << std::endl;
+      exit(1);
+    }
+
+    std::copy(bytes.begin(), bytes.end(), ram.begin() + address);
+  }
+
+  // Same, from an image of little-endian words (see filetorom.py)
+  void LoadRam(std::vector<uint32_t> const& words, size_t const address = 0)
+  {
+    if (address > ram.size() || words.size() > (ram.size() - address) / 4)
+    {
+      std::cerr << "Can't fit " << words.size() << " words in RAM at 0x" << std::hex << address << std::dec << std::endl;
+      exit(1);
+    }
+
+    uint8_t* out = ram.data() + address;
+
+    for (uint32_t const word : words)
+    {
+      out[0] = word;
+      out[1] = word >> 8;
+      out[2] = word >> 16;
+      out[3] = word >> 24;
+      out += 4;
+    }
+  }
+
+  uint32_t Register(int const index) const
+  {
+    return registers[index];
+  }
+
+  uint32_t Pc() const
+  {
+    return pc;
+  }
+
+  // Instructions run so far, the HLT that stopped it included
+  uint64_t Steps() const
+  {
+    return steps;
+  }
+
+  // Runs until HLT, or until max_steps more instructions have run
+  Status Run(uint64_t const max_steps, Engine const engine = Engine::THREADED)
+  {
+    return (engine == Engine::SWITCH) ? RunSwitch(max_steps) : RunThreaded(max_steps);
+  }
+};
+
+
+} // namespace day05
+
+
+#endif // DAY05_CPU_INCLUDED
@@ -13,12 +13,14 @@ Options:
 '''
 
 
+import os
+
 import docopt
 
 
 def main(args):
     input_path = args["<input-file>"]
-    output_path = input_filename.split('.')[0] if args["--output"] is None else args["--output"]
+    output_path = os.path.splitext(input_path)[0] + ".hex" if args["--output"] is None else args["--output"]
 
     with open(input_path) as f_in:
         with open(output_path, "w") as f_out:
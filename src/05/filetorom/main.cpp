@@ -0,0 +1,76 @@
+#include "../image.hpp"
+
+#include "mappedfile.hpp"
+#include "timescope.hpp"
+
+#include "docopt/docopt.h"
+
+#include <string>
+#include <fstream>
+#include <iostream>
+
+
+using namespace day05;
+
+
+static const char USAGE[] =
+R"(Day 05 RAM image encoder v1.0.
+
+Packs a file into 32-bit little-endian words for the CPU's RAM, like
+filetorom.py, with at least one zero byte after it to mark the end. The file
+is mapped and packed in bulk, so it takes about as long as reading it.
+
+The image is written for Logisim ("v2.0 raw" hex, the same as filetorom.py
+writes), or with --binary for the emulator, which is the file itself plus
+the zeros. Unless --output is given, the image goes next to the input with
+the extension .hex (or .bin).
+
+Usage:
+  a.out [options] <input-file>
+  a.out (-h | --help)
+
+Options:
+  -h --help            Print this help message.
+  -o --output <file>   Path to output encoded file to.
+  -b --binary          Write a binary image instead of a hex one.
+)";
+
+
+int main(int argc, char **argv)
+{
+  auto args = docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
+
+  std::string const input_path = args["<input-file>"].asString();
+  bool const binary = args["--binary"].asBool();
+  std::string const output_path = args["--output"] ? args["--output"].asString() : ImagePath(input_path, binary);
+
+  MappedFile const input(input_path);
+  std::ofstream ofs(output_path, std::ios::binary);
+
+  if (!ofs)
+  {
+    std::cerr << "Could not open " << output_path << " for writing" << std::endl;
+    return 1;
+  }
+
+  {
+    TimeScope t("Encode");
+
+    if (binary)
+    {
+      WriteBinary(ofs, input.View());
+    }
+    else
+    {
+      WriteImage(ofs, input.View());
+    }
+  }
+
+  if (!ofs.flush())
+  {
+    std::cerr << "Could not write " << output_path << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
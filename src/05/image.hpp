@@ -0,0 +1,324 @@
+#ifndef DAY05_IMAGE_INCLUDED
+#define DAY05_IMAGE_INCLUDED
+
+#include "stringutil.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <ostream>
+
+
+namespace day05
+{
+
+
+std::string_view const IMAGE_HEADER = "v2.0 raw";
+
+
+inline bool IsImage(std::string_view const text)
+{
+  return text.substr(0, IMAGE_HEADER.size()) == IMAGE_HEADER;
+}
+
+
+// The value of each hex digit, -1 for anything else
+inline std::array<int8_t, 256> const HEX_DIGITS = []
+{
+  std::array<int8_t, 256> digits;
+  digits.fill(-1);
+
+  for (int i = 0; i < 16; i++)
+  {
+    digits["0123456789abcdef"[i]] = i;
+    digits["0123456789ABCDEF"[i]] = i;
+  }
+
+  return digits;
+}();
+
+
+// The words of a Logisim "v2.0 raw" memory image, as written by asm.py and
+// filetorom.py: hex values separated by whitespace, "count*value" for runs
+// of the same value, and '#' to the end of the line for comments.
+inline std::vector<uint32_t> ParseImage(std::string_view const text, std::string_view const name)
+{
+  if (!IsImage(text))
+  {
+    std::cerr << "'" << name << "' is not a '" << IMAGE_HEADER << "' image" << std::endl;
+    exit(1);
+  }
+
+  std::vector<uint32_t> words;
+  size_t pos = IMAGE_HEADER.size();
+
+  // About right for one word a line, as asm.py and filetorom.py write them
+  words.reserve(text.size() / 9);
+
+  auto const Malformed = [&](std::string_view const token)
+  {
+    std::cerr << "Malformed word '" << token << "' in '" << name << "'" << std::endl;
+    exit(1);
+  };
+
+  auto const Number = [&](std::string_view const token, int const base)
+  {
+    uint64_t value = 0;
+    char const* const end = token.data() + token.size();
+    auto const [ptr, error] = std::from_chars(token.data(), end, value, base);
+
+    if (token.empty() || error != std::errc() || ptr != end || value > UINT32_MAX)
+    {
+      Malformed(token);
+    }
+
+    return static_cast<uint32_t>(value);
+  };
+
+  auto const Separator = [](char const c)
+  {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '#';
+  };
+
+  while (pos < text.size())
+  {
+    char const c = text[pos];
+
+    if (c == '#')
+    {
+      size_t const newline = text.find('\n', pos);
+      pos = (newline == std::string_view::npos) ? text.size() : newline;
+      continue;
+    }
+
+    if (Separator(c))
+    {
+      pos++;
+      continue;
+    }
+
+    // Nearly every token is a plain word of up to eight digits
+    uint32_t word = 0;
+    size_t end = pos;
+
+    for (; end < text.size() && end - pos < 8 && HEX_DIGITS[static_cast<unsigned char>(text[end])] >= 0; end++)
+    {
+      word = (word << 4) | HEX_DIGITS[static_cast<unsigned char>(text[end])];
+    }
+
+    if (end > pos && (end == text.size() || Separator(text[end])))
+    {
+      words.push_back(word);
+      pos = end;
+      continue;
+    }
+
+    end = pos + 1;
+
+    while (end < text.size() && !Separator(text[end]))
+    {
+      end++;
+    }
+
+    std::string_view const token = text.substr(pos, end - pos);
+    auto const [count, value] = SplitOnce(token, '*');
+
+    if (value.empty())
+    {
+      words.push_back(Number(token, 16));
+    }
+    else
+    {
+      words.insert(words.end(), Number(count, 10), Number(value, 16));
+    }
+
+    pos = end;
+  }
+
+  return words;
+}
+
+
+// The compact form of an image, its words as little-endian bytes. Put in
+// RAM, that is the same as the bytes it was made from.
+inline std::vector<uint32_t> ReadBinary(std::string_view const bytes, std::string_view const name)
+{
+  if (bytes.size() % 4 != 0)
+  {
+    std::cerr << "'" << name << "' is " << bytes.size() << " bytes, not a whole number of words" << std::endl;
+    exit(1);
+  }
+
+  std::vector<uint32_t> words(bytes.size() / 4);
+
+  for (size_t i = 0; i < words.size(); i++)
+  {
+    unsigned char const* const p = reinterpret_cast<unsigned char const*>(bytes.data()) + i * 4;
+    words[i] = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+  return words;
+}
+
+
+// Either kind, told apart by the header
+inline std::vector<uint32_t> ReadImage(std::string_view const contents, std::string_view const name)
+{
+  return IsImage(contents) ? ParseImage(contents, name) : ReadBinary(contents, name);
+}
+
+
+// A word in lower case hex without leading zeros and a newline, as asm.py
+// and filetorom.py write them. Returns the end of what it wrote. All eight
+// digits are worked out at once, a byte each, and always stored, so there
+// must be room for nine bytes at out.
+inline char* WriteHexLine(char* const out, uint32_t const word)
+{
+  int const count = (word == 0) ? 1 : (35 - __builtin_clz(word)) / 4;
+
+  // One nibble per byte, the lowest first
+  uint64_t x = word;
+  x = ((x & 0xffff0000) << 16) | (x & 0x0000ffff);
+  x = ((x & 0x0000ff000000ff00) << 8) | (x & 0x000000ff000000ff);
+  x = ((x & 0x00f000f000f000f0) << 4) | (x & 0x000f000f000f000f);
+
+  // '0' + nibble, and on to 'a' for those over 9
+  uint64_t const letters = ((x + 0x0606060606060606) >> 4) & 0x0101010101010101;
+  x += 0x3030303030303030 + letters * ('a' - '0' - 10);
+
+  // Most significant digit first, without the leading zeros
+  x = __builtin_bswap64(x) >> ((8 - count) * 8);
+  memcpy(out, &x, sizeof(x));
+
+  out[count] = '\n';
+  return out + count + 1;
+}
+
+
+// "v2.0 raw" text with a word per line
+inline std::string FormatImage(std::vector<uint32_t> const& words)
+{
+  std::string text(IMAGE_HEADER.size() + 1 + words.size() * 9, '\0');
+  char* out = std::copy(IMAGE_HEADER.begin(), IMAGE_HEADER.end(), text.data());
+
+  *out++ = '\n';
+
+  for (uint32_t const word : words)
+  {
+    out = WriteHexLine(out, word);
+  }
+
+  text.resize(out - text.data());
+  return text;
+}
+
+
+inline std::string FormatBinary(std::vector<uint32_t> const& words)
+{
+  std::string bytes(words.size() * 4, '\0');
+
+  for (size_t i = 0; i < words.size(); i++)
+  {
+    for (int j = 0; j < 4; j++)
+    {
+      bytes[i * 4 + j] = static_cast<char>(words[i] >> (j * 8));
+    }
+  }
+
+  return bytes;
+}
+
+
+// Words a file packs into the way filetorom.py does it: little-endian, and
+// with at least one zero byte after the end of the file, so that a program
+// reading it knows where to stop
+inline size_t PackedWords(size_t const bytes)
+{
+  return bytes / 4 + 1;
+}
+
+
+inline uint32_t PackedWord(std::string_view const bytes, size_t const index)
+{
+  unsigned char const* const p = reinterpret_cast<unsigned char const*>(bytes.data()) + index * 4;
+  size_t const available = bytes.size() - std::min(bytes.size(), index * 4);
+
+  if (available >= 4)
+  {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+  uint32_t word = 0;
+
+  for (size_t i = 0; i < available; i++)
+  {
+    word |= static_cast<uint32_t>(p[i]) << (i * 8);
+  }
+
+  return word;
+}
+
+
+// The packed file as a "v2.0 raw" image, formatted a block of words at a
+// time straight from the bytes, so only one block is ever held in memory
+inline void WriteImage(std::ostream& os, std::string_view const bytes)
+{
+  size_t const BLOCK = 1 << 16;
+  size_t const words = PackedWords(bytes.size());
+  std::vector<char> buffer(BLOCK * 9);
+
+  os << IMAGE_HEADER << '\n';
+
+  for (size_t first = 0; first < words; first += BLOCK)
+  {
+    size_t const last = std::min(words, first + BLOCK);
+    char* out = buffer.data();
+
+    for (size_t i = first; i < last; i++)
+    {
+      out = WriteHexLine(out, PackedWord(bytes, i));
+    }
+
+    os.write(buffer.data(), out - buffer.data());
+  }
+}
+
+
+// The packed file as a binary image, which is the file itself with the
+// zeros on the end
+inline void WriteBinary(std::ostream& os, std::string_view const bytes)
+{
+  char const zeros[4] = {};
+
+  os.write(bytes.data(), bytes.size());
+  os.write(zeros, PackedWords(bytes.size()) * 4 - bytes.size());
+}
+
+
+// Where an image of path goes by default: the same place, with the
+// extension .hex, or .bin for a binary one. What counts as the extension is
+// the same as for os.path.splitext, which filetorom.py uses: from the last
+// dot in the file name, unless the name only starts with dots.
+inline std::string ImagePath(std::string const& path, bool const binary)
+{
+  size_t const slash = path.find_last_of('/');
+  size_t const name = (slash == std::string::npos) ? 0 : slash + 1;
+  size_t const dot = path.find_last_of('.');
+  size_t const first = path.find_first_not_of('.', name);
+  bool const has_extension = dot != std::string::npos && dot >= name && first != std::string::npos && dot > first;
+
+  return (has_extension ? path.substr(0, dot) : path) + (binary ? ".bin" : ".hex");
+}
+
+
+} // namespace day05
+
+
+#endif // DAY05_IMAGE_INCLUDED
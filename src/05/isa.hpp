@@ -0,0 +1,295 @@
+#ifndef DAY05_ISA_INCLUDED
+#define DAY05_ISA_INCLUDED
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cctype>
+
+
+namespace day05
+{
+
+
+// The instruction set of cpu.circ, as defined in asm.py. Field positions are
+// numbered from the most significant bit, the way asm.py numbers them, so
+// the opcode (0-7) is bits 31..24 of the word.
+enum class FieldType
+{
+  OPCODE,
+  IMMEDIATE,
+  REG_ADDR
+};
+
+
+struct Field
+{
+  FieldType type;
+  unsigned start;
+  unsigned end;
+
+  constexpr unsigned Size() const
+  {
+    return end - start + 1;
+  }
+
+  constexpr unsigned Shift() const
+  {
+    return 31 - end;
+  }
+
+  constexpr uint32_t Mask() const
+  {
+    return (Size() == 32) ? UINT32_MAX : (1u << Size()) - 1;
+  }
+
+  constexpr uint32_t Extract(uint32_t const word) const
+  {
+    return (word >> Shift()) & Mask();
+  }
+
+  // Sign extended from the top bit of the field
+  constexpr int32_t ExtractSigned(uint32_t const word) const
+  {
+    uint32_t const sign = 1u << (Size() - 1);
+    return static_cast<int32_t>((Extract(word) ^ sign) - sign);
+  }
+
+  // Like asm.py, anything from the most negative signed value to the
+  // largest unsigned one fits, and only the low bits are kept
+  constexpr bool Fits(int64_t const value) const
+  {
+    return value >= -(int64_t(1) << (Size() - 1)) && value <= (int64_t(1) << Size()) - 1;
+  }
+
+  constexpr uint32_t Insert(uint32_t const word, int64_t const value) const
+  {
+    return word | ((static_cast<uint32_t>(value) & Mask()) << Shift());
+  }
+};
+
+
+constexpr Field OPCODE_FIELD = {FieldType::OPCODE, 0, 7};
+constexpr Field IMMEDIATE_16 = {FieldType::IMMEDIATE, 8, 23};
+constexpr Field IMMEDIATE_8 = {FieldType::IMMEDIATE, 16, 23};
+constexpr Field IMMEDIATE_24 = {FieldType::IMMEDIATE, 8, 31};
+constexpr Field REGISTER_A = {FieldType::REG_ADDR, 12, 15};
+constexpr Field REGISTER_B = {FieldType::REG_ADDR, 20, 23};
+constexpr Field REGISTER_C = {FieldType::REG_ADDR, 28, 31};
+
+
+enum class Format
+{
+  OP_ONLY,
+  OP_16BIMM_REG,
+  OP_REG_NOTHING_REG,
+  OP_REG_REG_REG,
+  OP_REG_8BIMM_REG,
+  OP_REG_REG_NOTHING,
+  OP_24BIMM,
+  OP_NOTHING_REG_NOTHING
+};
+
+
+// The fields of each format, in the order their tokens are written
+inline std::vector<Field> const& FormatFields(Format const format)
+{
+  static std::vector<Field> const formats[] = {
+    {OPCODE_FIELD},
+    {OPCODE_FIELD, IMMEDIATE_16, REGISTER_C},
+    {OPCODE_FIELD, REGISTER_A, REGISTER_C},
+    {OPCODE_FIELD, REGISTER_A, REGISTER_B, REGISTER_C},
+    {OPCODE_FIELD, REGISTER_A, IMMEDIATE_8, REGISTER_C},
+    {OPCODE_FIELD, REGISTER_A, REGISTER_B},
+    {OPCODE_FIELD, IMMEDIATE_24},
+    {OPCODE_FIELD, REGISTER_B}
+  };
+
+  return formats[static_cast<int>(format)];
+}
+
+
+// Only the instructions asm.py gives an id; the rest (ADDC, the logic ops,
+// JMPR, LD16, CALLR, ...) were never built into the CPU
+enum Opcode : uint8_t
+{
+  HLT = 0x00,
+  MOVI = 0x01,
+  MOVIL = 0x02,
+  MOVIH = 0x03,
+  MOV = 0x04,
+  ADD = 0x05,
+  ADDI = 0x06,
+  SUB = 0x08,
+  SUBI = 0x09,
+  CMP = 0x14,
+  JMP = 0x15,
+  JMPZ = 0x16,
+  JMPNZ = 0x17,
+  JMPLZ = 0x18,
+  JMPGZ = 0x19,
+  LD32 = 0x20,
+  LD8 = 0x23,
+  LD8S = 0x24,
+  ST32 = 0x25,
+  CALL = 0x30,
+  RET = 0x32
+};
+
+
+struct InstructionDefinition
+{
+  char const* mnemonic;
+  Opcode opcode;
+  Format format;
+  bool relative_immediates;  // immediates are relative to the instruction's own address
+  char const* description;
+};
+
+
+inline std::vector<InstructionDefinition> const& Instructions()
+{
+  static std::vector<InstructionDefinition> const instructions = {
+    {"HLT", HLT, Format::OP_ONLY, false,
+      "Halts the processor on the current instruction."},
+    {"MOVI", MOVI, Format::OP_16BIMM_REG, false,
+      "Move a 16 bit immediate into the low bytes of a register and sign extend."},
+    {"MOVIL", MOVIL, Format::OP_16BIMM_REG, false,
+      "Move a 16 bit immediate into the low bytes of a register."},
+    {"MOVIH", MOVIH, Format::OP_16BIMM_REG, false,
+      "Move a 16 bit immediate into the high bytes of a register."},
+    {"MOV", MOV, Format::OP_REG_NOTHING_REG, false,
+      "Copy the contents of one register to another."},
+    {"ADD", ADD, Format::OP_REG_REG_REG, false,
+      "Add first and second register, store result in third register."},
+    {"ADDI", ADDI, Format::OP_REG_8BIMM_REG, false,
+      "Add an immediate value to a register and store the result in another register."},
+    {"SUB", SUB, Format::OP_REG_REG_REG, false,
+      "Subtract second register from first register and store in third register."},
+    {"SUBI", SUBI, Format::OP_REG_8BIMM_REG, false,
+      "Subtract an immediate value from a register and store the result in another register."},
+    {"CMP", CMP, Format::OP_REG_REG_NOTHING, false,
+      "Compare two registers and set the status register without storing the result."},
+    {"JMP", JMP, Format::OP_24BIMM, true,
+      "Unconditional PC relative jump based on sign extended 24 bit immediate."},
+    {"JMPZ", JMPZ, Format::OP_24BIMM, true,
+      "PC relative jump based on sign extended 24 bit immediate if zero flag is set."},
+    {"JMPNZ", JMPNZ, Format::OP_24BIMM, true,
+      "PC relative jump based on sign extended 24 bit immediate if zero flag is not set."},
+    {"JMPLZ", JMPLZ, Format::OP_24BIMM, true,
+      "PC relative jump based on sign extended 24 bit immediate if less than zero flag is set."},
+    {"JMPGZ", JMPGZ, Format::OP_24BIMM, true,
+      "PC relative jump based on sign extended 24 bit immediate if greater than zero flag is set."},
+    {"LD32", LD32, Format::OP_REG_8BIMM_REG, false,
+      "Fetch the 32b word at the address in the first register offset by a sign extended 8 bit immediate into the second register."},
+    {"LD8", LD8, Format::OP_REG_8BIMM_REG, false,
+      "Fetch the 8b word at the address in the first register offset by a sign extended 8 bit immediate into the second register."},
+    {"LD8S", LD8S, Format::OP_REG_8BIMM_REG, false,
+      "Fetch the sign extended 8b word at the address in the first register offset by a sign extended 8 bit immediate into the second register."},
+    {"ST32", ST32, Format::OP_REG_8BIMM_REG, false,
+      "Store the value of the last register at the address in the first register offset by a sign extended 8 bit immediate."},
+    {"CALL", CALL, Format::OP_24BIMM, true,
+      "Pushes r5-14 onto the stack, sets LR to the current PC value + 1, then performs a relative jump by 24b sign extended immediate."},
+    {"RET", RET, Format::OP_ONLY, false,
+      "Jumps to the location stored in the link register, then pops r5-14 from the stack."}
+  };
+
+  return instructions;
+}
+
+
+// nullptr for opcodes the CPU doesn't have
+inline InstructionDefinition const* FindInstruction(uint8_t const opcode)
+{
+  static std::vector<InstructionDefinition const*> const by_opcode = []
+  {
+    std::vector<InstructionDefinition const*> table(256, nullptr);
+
+    for (InstructionDefinition const& definition : Instructions())
+    {
+      table[definition.opcode] = &definition;
+    }
+
+    return table;
+  }();
+
+  return by_opcode[opcode];
+}
+
+
+// By mnemonic, which is case sensitive as it is in asm.py
+inline InstructionDefinition const* FindInstruction(std::string_view const mnemonic)
+{
+  static std::unordered_map<std::string_view, InstructionDefinition const*> const by_mnemonic = []
+  {
+    std::unordered_map<std::string_view, InstructionDefinition const*> table;
+
+    for (InstructionDefinition const& definition : Instructions())
+    {
+      table[definition.mnemonic] = &definition;
+    }
+
+    return table;
+  }();
+
+  auto const it = by_mnemonic.find(mnemonic);
+  return (it == by_mnemonic.end()) ? nullptr : it->second;
+}
+
+
+int const REGISTER_COUNT = 16;
+int const LINK_REGISTER = 14;
+int const STACK_POINTER = 15;
+
+// CALL saves these, RET restores them
+int const FIRST_SAVED_REGISTER = 5;
+int const LAST_SAVED_REGISTER = 14;
+
+
+// R0-R15, LR and SP in any case, -1 if it isn't a register
+inline int RegisterIndex(std::string_view const name)
+{
+  std::string upper(name);
+
+  for (char& c : upper)
+  {
+    c = std::toupper(static_cast<unsigned char>(c));
+  }
+
+  if (upper == "LR")
+  {
+    return LINK_REGISTER;
+  }
+
+  if (upper == "SP")
+  {
+    return STACK_POINTER;
+  }
+
+  if (upper.size() < 2 || upper.size() > 3 || upper[0] != 'R')
+  {
+    return -1;
+  }
+
+  int index = 0;
+
+  for (size_t i = 1; i < upper.size(); i++)
+  {
+    if (!std::isdigit(static_cast<unsigned char>(upper[i])) || (i == 1 && upper[i] == '0' && upper.size() > 2))
+    {
+      return -1;
+    }
+
+    index = index * 10 + (upper[i] - '0');
+  }
+
+  return (index < REGISTER_COUNT) ? index : -1;
+}
+
+
+} // namespace day05
+
+
+#endif // DAY05_ISA_INCLUDED
@@ -0,0 +1,216 @@
+#include "cpu.hpp"
+#include "image.hpp"
+#include "solver.hpp"
+
+#include "mappedfile.hpp"
+#include "timescope.hpp"
+
+#include "docopt/docopt.h"
+
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+
+using namespace day05;
+
+
+static const char USAGE[] =
+R"(Day 05 CPU emulator v1.0.
+
+Runs a program assembled by asm.py or asm/ (e.g. from part1.s) on an
+emulation of cpu.circ, instead of Logisim. The input is put in RAM from
+address 0: either the puzzle input itself, or a RAM image made by
+filetorom.py. When the program halts, its result is in r0.
+
+The threaded engine decodes the program once and runs it as threaded code,
+the switch engine decodes each instruction as it goes. With --bench, both
+run the program that many times and their speeds are compared.
+
+--check compares r0 with the answer to part 1 or 2 worked out on the host,
+and --solve just prints those answers.
+
+Usage:
+  a.out [options] <program> <input>
+  a.out --solve <input>
+  a.out (-h | --help)
+
+Options:
+  -h --help              Print this help message.
+  --ram-size <bytes>     Bytes of RAM, a power of two [default: 65536].
+  --max-steps <count>    Instructions to run before giving up [default: 10000000000].
+  -r --registers         Print every register, not just r0.
+  -e --engine <name>     threaded or switch [default: threaded].
+  -b --bench <runs>      Time both engines over this many runs.
+  -c --check <part>      Exit with an error unless r0 is the answer to part 1 or 2.
+  --solve                Solve on the host instead of running a program.
+)";
+
+
+Cpu::Engine ParseEngine(std::string const& name)
+{
+  if (name == "threaded")
+  {
+    return Cpu::Engine::THREADED;
+  }
+
+  if (name == "switch")
+  {
+    return Cpu::Engine::SWITCH;
+  }
+
+  std::cerr << "'" << name << "' is not an engine, expected threaded or switch" << std::endl;
+  exit(1);
+}
+
+
+// Runs the program to the end, and returns how many seconds it took
+double Run(Cpu& cpu, Cpu::Engine const engine, uint64_t const max_steps)
+{
+  auto const t_start = std::chrono::steady_clock::now();
+  Cpu::Status const status = cpu.Run(max_steps, engine);
+  double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+
+  if (status != Cpu::Status::HALTED)
+  {
+    std::cerr << "Still running at 0x" << std::hex << cpu.Pc() << std::dec << " after " << cpu.Steps() << " instructions" << std::endl;
+    exit(1);
+  }
+
+  return seconds;
+}
+
+
+// The best of runs for each engine, each from a copy of the loaded machine
+void Bench(Cpu const& loaded, unsigned const runs, uint64_t const max_steps)
+{
+  std::vector<std::pair<char const*, Cpu::Engine>> const engines = {
+    {"switch", Cpu::Engine::SWITCH},
+    {"threaded", Cpu::Engine::THREADED}
+  };
+
+  std::vector<double> mips;
+  Cpu first = loaded;
+
+  Run(first, engines.front().second, max_steps);
+
+  printf("%-10s %14s %12s %10s\n", "engine", "instructions", "best (ms)", "MIPS");
+
+  for (auto const& [name, engine] : engines)
+  {
+    double best = 0;
+
+    for (unsigned i = 0; i < runs; i++)
+    {
+      Cpu cpu = loaded;
+      double const seconds = Run(cpu, engine, max_steps);
+
+      if (cpu.Register(0) != first.Register(0) || cpu.Steps() != first.Steps())
+      {
+        std::cerr << "The " << name << " engine disagrees with the switch engine!" << std::endl;
+        exit(1);
+      }
+
+      best = (i == 0) ? seconds : std::min(best, seconds);
+    }
+
+    mips.push_back(first.Steps() / best / 1e6);
+    printf("%-10s %14llu %12.4f %10.1f\n", name, static_cast<unsigned long long>(first.Steps()), best * 1e3, mips.back());
+  }
+
+  printf("threaded is %.2fx the switch\n", mips[1] / mips[0]);
+}
+
+
+int main(int argc, char **argv)
+{
+  auto args = docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
+
+  std::string const input_path = args["<input>"].asString();
+  MappedFile const input(input_path);
+
+  if (args["--solve"].asBool())
+  {
+    TimeScope t("Solve");
+    std::cout << Solve(input.View());
+    return 0;
+  }
+
+  std::string const program_path = args["<program>"].asString();
+  uint64_t const max_steps = std::stoull(args["--max-steps"].asString());
+
+  MappedFile const program(program_path);
+
+  Cpu cpu(ReadImage(program.View(), program_path), std::stoull(args["--ram-size"].asString()));
+
+  if (IsImage(input.View()))
+  {
+    cpu.LoadRam(ParseImage(input.View(), input_path));
+  }
+  else
+  {
+    // Zero terminated, as filetorom.py leaves it
+    cpu.LoadRam(input.View());
+  }
+
+  if (args["--bench"])
+  {
+    unsigned const runs = args["--bench"].asLong();
+
+    if (runs == 0)
+    {
+      std::cerr << "Need at least one run" << std::endl;
+      return 1;
+    }
+
+    Bench(cpu, runs, max_steps);
+    return 0;
+  }
+
+  double seconds = 0;
+
+  {
+    TimeScope t("Run");
+    seconds = Run(cpu, ParseEngine(args["--engine"].asString()), max_steps);
+  }
+
+  int const shown = args["--registers"].asBool() ? REGISTER_COUNT : 1;
+
+  for (int i = 0; i < shown; i++)
+  {
+    uint32_t const value = cpu.Register(i);
+    std::cout << "r" << i << ": " << value << " (0x" << std::hex << value << std::dec << ")" << std::endl;
+  }
+
+  std::cout << "instructions: " << cpu.Steps() << " (" << std::fixed << std::setprecision(1)
+            << cpu.Steps() / seconds / 1e6 << " MIPS)" << std::endl;
+
+  if (args["--check"])
+  {
+    long const part = args["--check"].asLong();
+
+    // The program reads up to the first zero, and so does the host
+    std::string const bytes = IsImage(input.View()) ? FormatBinary(ParseImage(input.View(), input_path)) : std::string(input.View());
+    SeatMap const seats = ScanPasses(std::string_view(bytes.c_str()));
+
+    if (part != 1 && part != 2)
+    {
+      std::cerr << "There is no part " << part << std::endl;
+      return 1;
+    }
+
+    int const expected = (part == 1) ? seats.Highest() : seats.Missing();
+
+    if (cpu.Register(0) != static_cast<uint32_t>(expected))
+    {
+      std::cerr << "r0 should be " << expected << " for part " << part << std::endl;
+      return 1;
+    }
+
+    std::cout << "check: r0 is the answer to part " << part << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,266 @@
+#ifndef DAY05_SOLVER_INCLUDED
+#define DAY05_SOLVER_INCLUDED
+
+#include "stringutil.hpp"
+#include "timescope.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+namespace day05
+{
+
+
+// A boarding pass is a 10-bit seat ID written in binary, most significant
+// bit first, with B or R for one and F or L for zero. part1.s and part2.s
+// work it out a bit at a time on the CPU; this is the same on the host, as
+// a reference for them and for inputs too big for the CPU's memory.
+size_t const PASS_LENGTH = 11;  // the code and its newline
+int const SEATS = 1024;
+
+
+// The seats with a pass, one bit each
+struct SeatMap
+{
+  std::array<uint64_t, SEATS / 64> taken = {};
+  size_t passes = 0;
+
+  void Add(unsigned const id)
+  {
+    taken[id / 64] |= uint64_t(1) << (id % 64);
+    passes++;
+  }
+
+  // -1 if there are no passes
+  int Highest() const
+  {
+    for (size_t i = taken.size(); i-- > 0;)
+    {
+      if (taken[i] != 0)
+      {
+        return i * 64 + 63 - __builtin_clzll(taken[i]);
+      }
+    }
+
+    return -1;
+  }
+
+  // The first free seat with taken seats on both sides, -1 if there isn't one
+  int Missing() const
+  {
+    for (size_t i = 0; i < taken.size(); i++)
+    {
+      uint64_t const left = (taken[i] << 1) | (i > 0 ? taken[i - 1] >> 63 : 0);
+      uint64_t const right = (taken[i] >> 1) | (i + 1 < taken.size() ? taken[i + 1] << 63 : 0);
+      uint64_t const free = ~taken[i] & left & right;
+
+      if (free != 0)
+      {
+        return i * 64 + __builtin_ctzll(free);
+      }
+    }
+
+    return -1;
+  }
+};
+
+
+// One line at a time, for whatever the batches can't take: blank lines,
+// carriage returns and the lines at the end
+inline void AddPass(std::string_view const line, SeatMap& seats)
+{
+  std::string_view const code = trim(line);
+  unsigned id = 0;
+
+  if (code.empty())
+  {
+    return;
+  }
+
+  if (code.size() != PASS_LENGTH - 1)
+  {
+    std::cerr << "Malformed boarding pass: '" << line << "'" << std::endl;
+    exit(1);
+  }
+
+  for (char const c : code)
+  {
+    if (c != 'B' && c != 'F' && c != 'R' && c != 'L')
+    {
+      std::cerr << "Malformed boarding pass: '" << line << "'" << std::endl;
+      exit(1);
+    }
+
+    id = (id << 1) | (c == 'B' || c == 'R');
+  }
+
+  seats.Add(id);
+}
+
+
+#if defined(__AVX2__)
+size_t const PASS_BATCH = 32;
+#elif defined(__SSE2__)
+size_t const PASS_BATCH = 16;
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+// Decodes PASS_BATCH passes from a block of that many whole lines: every
+// byte is compared against the letters and the newline, and the movemasks
+// are laid end to end, a bit per byte. Since every pass is the same length,
+// that is exactly the bits of each pass at a fixed offset, and the ones and
+// zeros just need to be read back the other way round. False, without
+// adding anything, if the lines aren't all PASS_LENGTH long and made of
+// the right letters.
+inline bool AddPassBatch(char const* const block, SeatMap& seats)
+{
+  size_t const BYTES = PASS_BATCH * PASS_LENGTH;
+  size_t const WORDS = (BYTES + 63) / 64 + 1;  // one spare, for reading past the last pass
+
+  struct Tables
+  {
+    uint64_t newlines[WORDS] = {};
+    uint64_t letters[WORDS] = {};
+    uint16_t reversed[SEATS] = {};
+  };
+
+  static Tables const tables = []
+  {
+    Tables t;
+
+    for (size_t bit = 0; bit < BYTES; bit++)
+    {
+      bool const newline = (bit % PASS_LENGTH == PASS_LENGTH - 1);
+      (newline ? t.newlines : t.letters)[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+
+    for (int id = 0; id < SEATS; id++)
+    {
+      for (int bit = 0; bit < 10; bit++)
+      {
+        t.reversed[id] |= ((id >> bit) & 1) << (9 - bit);
+      }
+    }
+
+    return t;
+  }();
+
+  uint64_t ones[WORDS] = {};
+  uint64_t letters[WORDS] = {};
+  uint64_t newlines[WORDS] = {};
+
+#if defined(__AVX2__)
+  __m256i const b = _mm256_set1_epi8('B');
+  __m256i const r = _mm256_set1_epi8('R');
+  __m256i const f = _mm256_set1_epi8('F');
+  __m256i const l = _mm256_set1_epi8('L');
+  __m256i const newline = _mm256_set1_epi8('\n');
+
+  for (size_t i = 0; i < BYTES; i += 32)
+  {
+    __m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block + i));
+    __m256i const one = _mm256_or_si256(_mm256_cmpeq_epi8(v, b), _mm256_cmpeq_epi8(v, r));
+    __m256i const zero = _mm256_or_si256(_mm256_cmpeq_epi8(v, f), _mm256_cmpeq_epi8(v, l));
+
+    ones[i / 64] |= uint64_t(uint32_t(_mm256_movemask_epi8(one))) << (i % 64);
+    letters[i / 64] |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_or_si256(one, zero)))) << (i % 64);
+    newlines[i / 64] |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline)))) << (i % 64);
+  }
+#else
+  __m128i const b = _mm_set1_epi8('B');
+  __m128i const r = _mm_set1_epi8('R');
+  __m128i const f = _mm_set1_epi8('F');
+  __m128i const l = _mm_set1_epi8('L');
+  __m128i const newline = _mm_set1_epi8('\n');
+
+  for (size_t i = 0; i < BYTES; i += 16)
+  {
+    __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + i));
+    __m128i const one = _mm_or_si128(_mm_cmpeq_epi8(v, b), _mm_cmpeq_epi8(v, r));
+    __m128i const zero = _mm_or_si128(_mm_cmpeq_epi8(v, f), _mm_cmpeq_epi8(v, l));
+
+    ones[i / 64] |= uint64_t(_mm_movemask_epi8(one)) << (i % 64);
+    letters[i / 64] |= uint64_t(_mm_movemask_epi8(_mm_or_si128(one, zero))) << (i % 64);
+    newlines[i / 64] |= uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline))) << (i % 64);
+  }
+#endif
+
+  if (memcmp(letters, tables.letters, sizeof(letters)) != 0 ||
+      memcmp(newlines, tables.newlines, sizeof(newlines)) != 0)
+  {
+    return false;
+  }
+
+  for (size_t bit = 0; bit < BYTES; bit += PASS_LENGTH)
+  {
+    uint64_t code = ones[bit / 64] >> (bit % 64);
+
+    if (bit % 64 > 64 - 10)
+    {
+      code |= ones[bit / 64 + 1] << (64 - bit % 64);
+    }
+
+    seats.Add(tables.reversed[code & (SEATS - 1)]);
+  }
+
+  return true;
+}
+#endif
+
+
+inline SeatMap ScanPasses(std::string_view const input)
+{
+  SeatMap seats;
+  char const* const data = input.data();
+  size_t pos = 0;
+
+  while (pos < input.size())
+  {
+#if defined(__AVX2__) || defined(__SSE2__)
+    if (input.size() - pos >= PASS_BATCH * PASS_LENGTH && AddPassBatch(data + pos, seats))
+    {
+      pos += PASS_BATCH * PASS_LENGTH;
+      continue;
+    }
+#endif
+
+    void const* const newline = memchr(data + pos, '\n', input.size() - pos);
+    size_t const end = newline ? static_cast<char const*>(newline) - data : input.size();
+
+    AddPass(input.substr(pos, end - pos), seats);
+    pos = end + 1;
+  }
+
+  return seats;
+}
+
+
+// Part one is the highest seat ID, part two the one free seat between two
+// taken ones, which is ours
+inline std::string Solve(std::string_view const input)
+{
+  SeatMap const seats = ScanPasses(input);
+  std::stringstream ss;
+
+  ss << "highest seat ID: " << seats.Highest() << std::endl;
+  ss << "missing seat ID: " << seats.Missing() << std::endl;
+
+  return ss.str();
+}
+
+
+} // namespace day05
+
+
+#endif // DAY05_SOLVER_INCLUDED
@@ -0,0 +1,126 @@
+#ifndef DAY06_SOLVER_INCLUDED
+#define DAY06_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "timescope.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <set>
+
+
+namespace day06
+{
+
+
+using namespace std;
+
+
+inline int CountAnswersAny(vector<string_view> const& answers)
+{
+  set<char> seen_chars;
+  int unique_chars = 0;
+
+  for (auto const answer : answers)
+  {
+    for (char const c : answer)
+    {
+      if (seen_chars.find(c) == seen_chars.end())
+      {
+        unique_chars++;
+        seen_chars.insert(c);
+      }
+    }
+  }
+
+  return unique_chars;
+}
+
+
+inline int CountAnswersAll(vector<string_view> const& answers)
+{
+  int count = 0;
+
+  for (char const c : answers.at(0))
+  {
+    int increment = 1;
+
+    for (unsigned i = 1; i < answers.size(); i++)
+    {
+      string_view const answer = answers.at(i);
+
+      if (answer.find_first_of(c) == string::npos)
+      {
+        increment = 0;
+        break;
+      }
+    }
+
+    count += increment;
+  }
+
+  return count;
+}
+
+
+inline int EnumerateAnswers(vector<string_view> const& answers, string const mode)
+{
+  if (mode == "any")
+  {
+    return CountAnswersAny(answers);
+  }
+  else if (mode == "all")
+  {
+    return CountAnswersAll(answers);
+  }
+  else
+  {
+    cerr << mode << " is not a valid mode!" << endl;
+    exit(1);
+  }
+}
+
+
+inline int SumAnswers(LineList const& lines, string const mode)
+{
+  int sum = 0;
+  vector<string_view> group;
+
+  for (auto const line : lines)
+  {
+    if (line != "")
+    {
+      group.push_back(line);
+    }
+    else
+    {
+      sum += EnumerateAnswers(group, mode);
+      group.clear();
+    }
+  }
+
+  sum += EnumerateAnswers(group, mode);
+
+  return sum;
+}
+
+
+inline string Solve(string_view const input)
+{
+  LineList const lines(input);
+  stringstream ss;
+
+  ss << "any: " << SumAnswers(lines, "any") << endl;
+  ss << "all: " << SumAnswers(lines, "all") << endl;
+
+  return ss.str();
+}
+
+
+} // namespace day06
+
+
+#endif // DAY06_SOLVER_INCLUDED
@@ -0,0 +1,175 @@
+#ifndef DAY07_SOLVER_INCLUDED
+#define DAY07_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "stringutil.hpp"
+#include "timescope.hpp"
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <map>
+#include <set>
+#include <iostream>
+
+
+namespace day07
+{
+
+
+using namespace std;
+
+
+typedef pair<string, int> BagSpec;
+typedef map<string, vector<BagSpec>> RuleMap;
+
+
+inline BagSpec NewBagSpec(string_view const str)
+{
+  auto const [count_str, description] = SplitOnce(trim(str), ' ');
+  auto const [adjective, colour_and_rest] = SplitOnce(description, ' ');
+
+  // Name is the first two words, e.g. "shiny gold"
+  size_t const name_size = adjective.size() + 1 + colour_and_rest.find(' ');
+
+  return make_pair(string(description.substr(0, name_size)), StringToInt(count_str));
+}
+
+
+inline RuleMap LoadRuleMap(LineList const& lines)
+{
+  RuleMap rules;
+
+  string_view const delimiter = " bags contain ";
+
+  for (auto const line : lines)
+  {
+    auto const [name_str, contains_str] = SplitOnce(line, delimiter);
+
+    vector<BagSpec>& specs = rules[string(trim(name_str))];
+
+    for (auto const spec_str : Split(trim(contains_str), ','))
+    {
+      if (trim(spec_str) != "no other bags.")
+      {
+        specs.push_back(NewBagSpec(spec_str));
+      }
+    }
+  }
+
+  return rules;
+}
+
+
+inline set<string> ContainableBags(
+  RuleMap const& rules,
+  string const bag_type,
+  map<string, set<string>>& containables_map)
+{
+  if (containables_map.find(bag_type) != containables_map.end())
+  {
+    return containables_map.at(bag_type);
+  }
+
+  set<string> containable;
+
+  for (auto const bag_spec : rules.at(bag_type))
+  {
+    string const interior_bag_type = bag_spec.first;
+
+    containable.insert(interior_bag_type);
+
+    for (auto const containable_name : ContainableBags(rules, interior_bag_type, containables_map))
+    {
+      containable.insert(containable_name);
+    }
+  }
+
+  containables_map.insert(make_pair(bag_type, containable));
+
+  return containable;
+}
+
+
+inline set<string> ContainableBags(
+  RuleMap const& rules,
+  string const bag_type)
+{
+  map<string, set<string>> containables_map;
+  return ContainableBags(rules, bag_type, containables_map);
+}
+
+
+inline int GetBagOptionCount(RuleMap const& rules, string const bag_type)
+{
+  int count = 0;
+
+  map<string, set<string>> containables_map;
+
+  for (auto const item : rules)
+  {
+    set<string> const containable = ContainableBags(rules, item.first, containables_map);
+
+    if (containable.find(bag_type) != containable.end())
+    {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+
+inline uint64_t GetBagCount(
+  RuleMap const& rules,
+  string const bag_type,
+  map<string, uint64_t>& counts_cache)
+{
+  if (counts_cache.find(bag_type) != counts_cache.end())
+  {
+    return counts_cache.at(bag_type);
+  }
+
+  uint64_t count = 0;
+
+  for (BagSpec const spec : rules.at(bag_type))
+  {
+    string const interior_bag_name = spec.first;
+    int const interior_bag_count = spec.second;
+
+    count += interior_bag_count;
+    count += interior_bag_count * GetBagCount(rules, interior_bag_name, counts_cache);
+  }
+
+  counts_cache.insert(make_pair(bag_type, count));
+
+  return count;
+}
+
+
+inline uint64_t GetBagCount(
+  RuleMap const& rules,
+  string const bag_type)
+{
+  map<string, uint64_t> counts_cache;
+  return GetBagCount(rules, bag_type, counts_cache);
+}
+
+
+inline string Solve(string_view const input)
+{
+  RuleMap const rules = LoadRuleMap(LineList(input));
+  stringstream ss;
+
+  ss << "options: " << GetBagOptionCount(rules, "shiny gold") << endl;
+  ss << "count: " << GetBagCount(rules, "shiny gold") << endl;
+
+  return ss.str();
+}
+
+
+} // namespace day07
+
+
+#endif // DAY07_SOLVER_INCLUDED
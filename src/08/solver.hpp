@@ -0,0 +1,185 @@
+#ifndef DAY08_SOLVER_INCLUDED
+#define DAY08_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "timescope.hpp"
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <charconv>
+#include <iostream>
+
+
+namespace day08
+{
+
+
+using namespace std;
+
+
+typedef enum {
+  NOP,
+  JMP,
+  ACC
+} Opcode;
+
+
+typedef pair<Opcode, int> Instruction;
+
+
+inline Opcode GetOpcode(string_view const str)
+{
+  if (str == "nop")
+  {
+    return NOP;
+  }
+  else if (str == "jmp")
+  {
+    return JMP;
+  }
+  else if (str == "acc")
+  {
+    return ACC;
+  }
+  else
+  {
+    cerr << "Invalid opcode \'" << str << '\'' << endl;
+    exit(1);
+  }
+}
+
+
+inline Instruction GetInstruction(string_view const line)
+{
+  size_t const space = line.find(' ');
+
+  string_view const opstr = line.substr(0, space);
+  char const plus_minus = space + 1 < line.size() ? line[space + 1] : '\0';
+  int value = 0;
+
+  if (space + 2 < line.size())
+  {
+    from_chars(line.data() + space + 2, line.data() + line.size(), value);
+  }
+
+  if (plus_minus != '-' && plus_minus != '+')
+  {
+    cerr << "Error, expected +/-, found '" << plus_minus << "'" << endl;
+    exit(1);
+  }
+
+  if (plus_minus == '-')
+  {
+    value = ~value + 1;
+  }
+
+  return Instruction(GetOpcode(opstr), value);
+}
+
+
+inline pair<int, bool> Execute(vector<Instruction> const program)
+{
+  vector<bool> executed(program.size(), false);
+
+  int program_counter = 0;
+  int accumulator = 0;
+  bool graceful_exit = false;
+
+  while (program_counter < program.size() && executed.at(program_counter) == false)
+  {
+    executed.at(program_counter) = true;
+
+    Instruction const instr = program.at(program_counter);
+
+    Opcode const opcode = instr.first;
+    int const argument = instr.second;
+
+    switch (opcode)
+    {
+      case NOP:
+        program_counter++;
+        break;
+
+      case JMP:
+        program_counter += argument;
+        break;
+
+      case ACC:
+        accumulator += argument;
+        program_counter++;
+        break;
+
+      default:
+        cerr << "Unrecognised opcode" << endl;
+        exit(1);
+    }
+  }
+
+  return make_pair(accumulator, program_counter == program.size());
+}
+
+
+inline vector<Instruction> LoadProgram(LineList const& lines)
+{
+  vector<Instruction> program;
+
+  for (auto const line : lines)
+  {
+    program.push_back(GetInstruction(line));
+  }
+
+  return program;
+}
+
+
+// Accumulator values of every single-instruction repair which terminates
+inline vector<int> RepairedResults(vector<Instruction> const& program)
+{
+  vector<int> results;
+
+  for (unsigned i = 0; i < program.size(); i++)
+  {
+    Instruction const instr = program.at(i);
+
+    Opcode const opcode = instr.first;
+
+    if (opcode == NOP || opcode == JMP)
+    {
+      vector<Instruction> mutated_program = program;
+
+      mutated_program.at(i).first = (opcode == NOP) ? JMP : NOP;
+
+      pair<int, bool> result = Execute(mutated_program);
+
+      if (result.second)
+      {
+        results.push_back(result.first);
+      }
+    }
+  }
+
+  return results;
+}
+
+
+inline string Solve(string_view const input)
+{
+  vector<Instruction> const program = LoadProgram(LineList(input));
+  stringstream ss;
+
+  ss << "run: " << Execute(program).first << endl;
+
+  for (int const result : RepairedResults(program))
+  {
+    ss << "fix: " << result << endl;
+  }
+
+  return ss.str();
+}
+
+
+} // namespace day08
+
+
+#endif // DAY08_SOLVER_INCLUDED
@@ -0,0 +1,155 @@
+#ifndef DAY09_SOLVER_INCLUDED
+#define DAY09_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "timescope.hpp"
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <charconv>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+
+namespace day09
+{
+
+
+using namespace std;
+
+
+template<class T>
+inline bool VectorContains(vector<T> const v, T const target)
+{
+  for (auto const element : v)
+  {
+    if (element == target)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+inline bool WindowContainsSumPair(vector<uint64_t> const& window, uint64_t const target)
+{
+  for (uint64_t const i : window)
+  {
+    uint64_t const required = target - i;
+
+    if (required != i && VectorContains(window, required))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+inline uint64_t FindErrorNumber(
+  vector<uint64_t> const& sequence,
+  unsigned const preamble)
+{
+  vector<uint64_t> window(preamble);
+  unsigned window_ptr = 0;
+
+  for (unsigned i = 0; i < preamble; i++)
+  {
+    window.at(i) = sequence.at(i);
+  }
+
+  for (unsigned i = preamble; i < sequence.size(); i++)
+  {
+    uint64_t const value = sequence.at(i);
+
+    if (!WindowContainsSumPair(window, value))
+    {
+      return value;
+    }
+
+    window.at(window_ptr) = value;
+    window_ptr = (window_ptr + 1) % preamble;
+  }
+
+  return 0;
+}
+
+
+inline vector<uint64_t> FindContiguousSum(vector<uint64_t> const& sequence, uint64_t const target)
+{
+  unsigned back = 0;
+  unsigned front = 1;
+
+  uint64_t current_sum = sequence.at(front) + sequence.at(back);
+
+  while (current_sum != target)
+  {
+    if (current_sum < target)
+    {
+      current_sum += sequence.at(++front);
+    }
+    else if (current_sum > target)
+    {
+      current_sum -= sequence.at(back++);
+    }
+  }
+
+  vector<uint64_t> contiguous_sum((front - back) + 1);
+
+  for (unsigned i = 0; i < contiguous_sum.size(); i++)
+  {
+    contiguous_sum.at(i) = sequence.at(back + i);
+  }
+
+  return contiguous_sum;
+}
+
+
+inline vector<uint64_t> LoadSequence(LineList const& lines)
+{
+  vector<uint64_t> sequence;
+
+  for (auto const line : lines)
+  {
+    uint64_t value = 0;
+    from_chars(line.data(), line.data() + line.size(), value);
+    sequence.push_back(value);
+  }
+
+  return sequence;
+}
+
+
+// Sum of the smallest and largest values in the contiguous range
+inline uint64_t ContiguousSumSignature(vector<uint64_t> const& sequence, uint64_t const target)
+{
+  vector<uint64_t> contiguous_sum = FindContiguousSum(sequence, target);
+  sort(contiguous_sum.begin(), contiguous_sum.end());
+
+  return contiguous_sum.back() + contiguous_sum.front();
+}
+
+
+inline string Solve(string_view const input)
+{
+  vector<uint64_t> const sequence = LoadSequence(LineList(input));
+  uint64_t const invalid_number = FindErrorNumber(sequence, 25);
+  stringstream ss;
+
+  ss << "Error number: " << invalid_number << endl;
+  ss << "Contiguous sum signature: " << ContiguousSumSignature(sequence, invalid_number) << endl;
+
+  return ss.str();
+}
+
+
+} // namespace day09
+
+
+#endif // DAY09_SOLVER_INCLUDED
@@ -0,0 +1,81 @@
+#ifndef DAY10_SOLVER_INCLUDED
+#define DAY10_SOLVER_INCLUDED
+
+#include "loadints.hpp"
+#include "timescope.hpp"
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+
+namespace day10
+{
+
+
+using namespace std;
+
+
+// Sorted ratings, with the device's built-in adapter on the end
+inline vector<int> PrepareJoltRatings(vector<int> jolt_ratings)
+{
+  sort(jolt_ratings.begin(), jolt_ratings.end());
+  jolt_ratings.push_back(jolt_ratings.back() + 3);
+  return jolt_ratings;
+}
+
+
+inline int GetJoltChecksum(vector<int> const jolt_ratings)
+{
+  int previous_jolt_rating = 0;
+  vector<int> difference_size_counts(3);
+
+  for (auto const jolt_rating : jolt_ratings)
+  {
+    int const diff = jolt_rating - previous_jolt_rating;
+    difference_size_counts.at(diff - 1)++;
+    previous_jolt_rating = jolt_rating;
+  }
+
+  return difference_size_counts.at(0) * difference_size_counts.at(2);
+}
+
+
+inline uint64_t CountConnectionPossibilities(vector<int> const jolt_ratings)
+{
+  vector<uint64_t> connection_possibilities(jolt_ratings.size(), 0);
+
+  for (int i = 0; i < jolt_ratings.size(); i++)
+  {
+    connection_possibilities.at(i) = jolt_ratings.at(i) <= 3 ? 1 : 0;
+
+    for (int j = i - 1; j >= 0 && jolt_ratings.at(i) - jolt_ratings.at(j) <= 3; j--)
+    {
+      connection_possibilities.at(i) += connection_possibilities.at(j);
+    }
+  }
+
+  return connection_possibilities.back();
+}
+
+
+inline string Solve(string_view const input)
+{
+  vector<int> const jolt_ratings = PrepareJoltRatings(LoadIntsFromBuffer(input, "input"));
+  stringstream ss;
+
+  ss << "checksum: " << GetJoltChecksum(jolt_ratings) << endl;
+  ss << "enumerate: " << CountConnectionPossibilities(jolt_ratings) << endl;
+
+  return ss.str();
+}
+
+
+} // namespace day10
+
+
+#endif // DAY10_SOLVER_INCLUDED
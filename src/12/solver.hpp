@@ -0,0 +1,243 @@
+#ifndef DAY12_SOLVER_INCLUDED
+#define DAY12_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "timescope.hpp"
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iostream>
+#include <charconv>
+#include <cstdlib>
+
+
+namespace day12
+{
+
+
+using namespace std;
+
+
+struct Vec2 {
+  int x = 0;
+  int y = 0;
+
+  Vec2(int const x, int const y) :
+    x(x), y(y)
+  {}
+
+  Vec2 operator*(int const multiplier) const
+  {
+    return Vec2(x * multiplier, y * multiplier);
+  }
+
+  Vec2 operator+(Vec2 const& other) const
+  {
+    return Vec2(x + other.x, y + other.y);
+  }
+
+  Vec2 operator-(Vec2 const& other) const
+  {
+    return Vec2(x - other.x, y - other.y);
+  }
+};
+
+
+typedef enum {
+  NORTH = 0,
+  EAST = 1,
+  SOUTH = 2,
+  WEST = 3
+} Direction;
+
+
+inline Vec2 DirectionToVec2(Direction const dir)
+{
+  switch (dir)
+  {
+    case NORTH:
+      return Vec2(0, 1);
+
+    case SOUTH:
+      return Vec2(0, -1);
+
+    case EAST:
+      return Vec2(1, 0);
+
+    case WEST:
+      return Vec2(-1, 0);
+
+    default:
+      cerr << "Invalid direction enum " << dir << endl;
+      exit(1);
+  }
+}
+
+
+inline Vec2 RotateVec2(Vec2 vec, int angle)
+{
+  if ((angle = angle % 360) < 0)
+  {
+    angle += 360;
+  }
+
+  while (angle != 0)
+  {
+    vec = Vec2(vec.y, 0 - vec.x);
+    angle -= 90;
+  }
+
+  return vec;
+}
+
+
+struct Instruction {
+  char opcode;
+  int operand;
+
+  Instruction(string_view const line) :
+    opcode(line.at(0)), operand(0)
+  {
+    from_chars(line.data() + 1, line.data() + line.size(), operand);
+  }
+};
+
+
+struct Ferry {
+  Vec2 heading;
+  Vec2 position;
+  Vec2 waypoint;
+
+  Ferry(Direction const heading, Vec2 const position, Vec2 const waypoint) :
+    heading(DirectionToVec2(heading)), position(position), waypoint(waypoint)
+  {}
+
+  void UpdateShipRelative(Instruction const instruction)
+  {
+    int const operand = instruction.operand;
+
+    switch (instruction.opcode)
+    {
+      case 'N':
+        position.y += operand;
+        break;
+
+      case 'S':
+        position.y -= operand;
+        break;
+
+      case 'E':
+        position.x += operand;
+        break;
+
+      case 'W':
+        position.x -= operand;
+        break;
+
+      case 'L':
+        heading = RotateVec2(heading, 0 - operand);
+        break;
+
+      case 'R':
+        heading = RotateVec2(heading, operand);
+        break;
+
+      case 'F':
+        position = position + (waypoint * operand);
+        break;
+
+      default:
+        cerr << "Invalid operation '" << instruction.opcode << '\'' << endl;
+        exit(1);
+    }
+  }
+
+  void UpdateWaypointRelative(Instruction const instruction)
+  {
+    int const operand = instruction.operand;
+
+    switch (instruction.opcode)
+    {
+      case 'N':
+        waypoint.y += operand;
+        break;
+
+      case 'S':
+        waypoint.y -= operand;
+        break;
+
+      case 'E':
+        waypoint.x += operand;
+        break;
+
+      case 'W':
+        waypoint.x -= operand;
+        break;
+
+      case 'L':
+        waypoint = RotateVec2(waypoint, 0 - operand);
+        break;
+
+      case 'R':
+        waypoint = RotateVec2(waypoint, operand);
+        break;
+
+      case 'F':
+        position = position + (waypoint * operand);
+        break;
+
+      default:
+        cerr << "Invalid operation '" << instruction.opcode << '\'' << endl;
+        exit(1);
+    }
+  }
+};
+
+
+// Manhattan distance from the origin after following the instructions
+inline int Navigate(LineList const& lines, string const mode)
+{
+  Ferry ferry(EAST, Vec2(0, 0), Vec2(10, 1));
+
+  if (mode == "ship")
+  {
+    for (auto const line : lines)
+    {
+      ferry.UpdateShipRelative(Instruction(line));
+    }
+  }
+  else if (mode == "waypoint")
+  {
+    for (auto const line : lines)
+    {
+      ferry.UpdateWaypointRelative(Instruction(line));
+    }
+  }
+  else
+  {
+    cerr << mode << " is not a valid mode!" << endl;
+    exit(1);
+  }
+
+  return abs(ferry.position.x) + abs(ferry.position.y);
+}
+
+
+inline string Solve(string_view const input)
+{
+  LineList const lines(input);
+  stringstream ss;
+
+  ss << "ship: " << Navigate(lines, "ship") << endl;
+  ss << "waypoint: " << Navigate(lines, "waypoint") << endl;
+
+  return ss.str();
+}
+
+
+} // namespace day12
+
+
+#endif // DAY12_SOLVER_INCLUDED
@@ -0,0 +1,164 @@
+#ifndef DAY13_SOLVER_INCLUDED
+#define DAY13_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "stringutil.hpp"
+#include "timescope.hpp"
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+
+namespace day13
+{
+
+
+using namespace std;
+
+
+struct Bus
+{
+  uint64_t id;
+  uint64_t position;
+
+  Bus(uint64_t const id, uint64_t const position) :
+    id(id), position(position)
+  {}
+
+  bool operator<(Bus const& other) const
+  {
+    return id > other.id;
+  }
+};
+
+
+struct Schedule
+{
+  uint64_t timestamp = 0;
+  vector<Bus> busses;
+};
+
+
+inline Schedule LoadSchedule(LineList const& lines)
+{
+  if (lines.size() < 2)
+  {
+    cerr << "Invalid input, not enough lines!" << endl;
+    exit(1);
+  }
+
+  Schedule schedule;
+
+  schedule.timestamp = StringToInt<uint64_t>(lines.at(0));
+
+  int i = 0;
+
+  for (auto const schedule_token : Split(lines.at(1), ','))
+  {
+    string_view const token = trim(schedule_token);
+
+    if (token != "x")
+    {
+      schedule.busses.push_back(Bus(StringToInt(token), i));
+    }
+
+    i++;
+  }
+
+  return schedule;
+}
+
+
+inline uint64_t WaitDuration(uint64_t const timestamp, Bus const bus)
+{
+  uint64_t const frequency = bus.id;
+
+  uint64_t wait_duration = 0;
+
+  if (timestamp % frequency != 0)
+  {
+    wait_duration = frequency - (timestamp % frequency);
+  }
+
+  return wait_duration;
+}
+
+
+inline pair<uint64_t, uint64_t> BestBus(int const timestamp, vector<Bus> const& busses)
+{
+  uint64_t best_bus_id;
+  uint64_t best_wait_duration = -1;
+
+  for (Bus const bus : busses)
+  {
+    uint64_t const wait_duration = WaitDuration(timestamp, bus);
+
+    if (wait_duration < best_wait_duration || best_wait_duration < 0)
+    {
+      best_wait_duration = wait_duration;
+      best_bus_id = bus.id;
+    }
+  }
+
+  return make_pair(best_bus_id, best_wait_duration);
+}
+
+
+inline bool TimestampIsAligned(uint64_t const timestamp, vector<Bus> const busses)
+{
+  for (Bus const bus : busses)
+  {
+    if (WaitDuration(timestamp + bus.position, bus) != 0)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+inline uint64_t FindAlignedTimestampFast(vector<Bus> busses)
+{
+  sort(busses.begin(), busses.end());
+
+  uint64_t timestamp = 0;
+  uint64_t i = 0;
+
+  uint64_t step = 1;
+
+  for (Bus const bus : busses)
+  {
+    while (WaitDuration(timestamp + bus.position, bus) != 0)
+    {
+      timestamp += step;
+    }
+
+    step *= bus.id;
+  }
+
+  return timestamp;
+}
+
+
+inline string Solve(string_view const input)
+{
+  Schedule const schedule = LoadSchedule(LineList(input));
+  auto const best_bus = BestBus(schedule.timestamp, schedule.busses);
+  stringstream ss;
+
+  ss << "Checksum: " << best_bus.first * best_bus.second << endl;
+  ss << "Timestamp: " << FindAlignedTimestampFast(schedule.busses) << endl;
+
+  return ss.str();
+}
+
+
+} // namespace day13
+
+
+#endif // DAY13_SOLVER_INCLUDED
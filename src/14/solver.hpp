@@ -0,0 +1,260 @@
+#ifndef DAY14_SOLVER_INCLUDED
+#define DAY14_SOLVER_INCLUDED
+
+#include "stringutil.hpp"
+#include "loadlines.hpp"
+#include "timescope.hpp"
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <iostream>
+
+
+namespace day14
+{
+
+
+using namespace std;
+
+
+enum Opcode {
+  NOP,
+  MASK,
+  MEM
+};
+
+
+enum Version {
+  V_01,
+  V_02
+};
+
+
+struct Instruction {
+public:
+  Opcode opcode = NOP;
+
+  uint64_t mem_address = 0;
+  uint64_t mem_value = 0;
+
+  uint64_t mask_set = 0;
+  uint64_t mask_clear = 0;
+
+
+private:
+  void MaskInstruction(string_view const line)
+  {
+    string_view const rhs = trim(SplitOnce(line, '=').second);
+
+    opcode = MASK;
+    mask_set = 0;
+    mask_clear = 0;
+
+    for (char const c : rhs)
+    {
+      mask_set = mask_set << 1;
+      mask_clear = mask_clear << 1;
+
+      switch (c)
+      {
+        case 'X':
+          break;
+
+        case '0':
+          mask_clear |= 0x01;
+          break;
+
+        case '1':
+          mask_set |= 0x01;
+          break;
+
+        default:
+          cerr << "Unexepcted mask character '" << c << "'." << endl;
+          exit(1);
+      }
+    }
+  }
+
+  void MemInstruction(string_view const line)
+  {
+    auto const [lhs, rhs] = SplitOnce(line, '=');
+
+    opcode = MEM;
+
+    mem_address = StringToInt<uint64_t>(SplitOnce(lhs, '[').second);
+    mem_value = StringToInt<uint64_t>(rhs);
+  }
+
+
+public:
+  Instruction(string_view const line)
+  {
+    if (line.find("mask") == 0)
+    {
+      MaskInstruction(line);
+    }
+    else if (line.find("mem") == 0)
+    {
+      MemInstruction(line);
+    }
+    else
+    {
+      cout << "Unrecognised instruction '" << line << '\'' << endl;
+      exit(1);
+    }
+  }
+};
+
+
+typedef vector<Instruction> Program;
+
+
+class Executor
+{
+private:
+  unsigned largest_floating_bit_count = 0;
+
+  uint64_t mask_set = 0;
+  uint64_t mask_clear = 0;
+
+  uint64_t address_mask = 0;
+
+  map<uint64_t, uint64_t> mem;
+
+public:
+  Executor (unsigned const address_space_size)
+  {
+    address_mask = ((uint64_t)0x01 << address_space_size) - 1;
+  }
+
+  uint64_t Read(uint64_t const address) const
+  {
+    if (mem.find(address) != mem.end())
+    {
+      return mem.at(address);
+    }
+
+    return 0;
+  }
+
+  void Write(uint64_t const value, uint64_t address, uint64_t floating_mask = 0)
+  {
+    address &= address_mask;
+    floating_mask &= address_mask;
+
+    if (floating_mask != 0)
+    {
+      uint64_t const new_floating_mask = floating_mask & (floating_mask - 1);
+      uint64_t const floating_lsb_mask = new_floating_mask ^ floating_mask;
+
+      uint64_t const addr_clear = address & ~floating_lsb_mask;
+      uint64_t const addr_set = address | floating_lsb_mask;
+
+      Write(value, addr_clear, new_floating_mask);
+      Write(value, addr_set, new_floating_mask);
+    }
+    else
+    {
+      mem[address] = value;
+    }
+  }
+
+  uint64_t MemoryChecksum() const
+  {
+    uint64_t sum = 0;
+
+    for (auto const item : mem)
+    {
+      sum += item.second;
+    }
+
+    return sum;
+  }
+
+  void Execute(Instruction const instr, Version const version = V_01)
+  {
+    switch (instr.opcode)
+    {
+      case MASK:
+        mask_set = instr.mask_set;
+        mask_clear = instr.mask_clear;
+        break;
+
+      case MEM:
+        switch (version)
+        {
+          case V_01:
+            Write((instr.mem_value | mask_set) & ~mask_clear, instr.mem_address);
+            break;
+
+          case V_02:
+            Write(instr.mem_value, instr.mem_address | mask_set, ~(mask_clear | mask_set));
+            break;
+
+          default:
+            cout << "Invalid version code." << endl;
+            exit(1);
+        }
+        break;
+
+      case NOP:
+        cerr << "Unexepcted NOP in program." << endl;
+        exit(1);
+
+      default:
+        cerr << "Unrecognised opcode in program." << endl;
+        exit(1);
+    }
+  }
+
+  void Execute(Program const program, Version const version = V_01)
+  {
+    for (auto const& instruction : program)
+    {
+      Execute(instruction, version);
+    }
+  }
+};
+
+
+inline Program LoadProgram(LineList const& lines)
+{
+  Program program;
+
+  for (auto const line : lines)
+  {
+    program.push_back(Instruction(line));
+  }
+
+  return program;
+}
+
+
+inline uint64_t RunDecoder(Program const& program, Version const version)
+{
+  Executor executor(36);
+  executor.Execute(program, version);
+  return executor.MemoryChecksum();
+}
+
+
+inline string Solve(string_view const input)
+{
+  Program const program = LoadProgram(LineList(input));
+  stringstream ss;
+
+  ss << "version 1: " << RunDecoder(program, V_01) << endl;
+  ss << "version 2: " << RunDecoder(program, V_02) << endl;
+
+  return ss.str();
+}
+
+
+} // namespace day14
+
+
+#endif // DAY14_SOLVER_INCLUDED
@@ -1,14 +1,14 @@
+#include "solver.hpp"
+
 #include "docopt/docopt.h"
-#include "loadlines.hpp"
-#include "stringutil.hpp"
 
 #include <vector>
 #include <string>
-#include <sstream>
 #include <map>
 
 
 using namespace std;
+using namespace day15;
 
 
 static const char USAGE[] =
@@ -31,44 +31,16 @@ int main(int argc, char **argv)
   string const path = args["<path>"].asString();
   int const target_turn = args["--turn"].asLong();
 
-  vector<int> sequence, starting_numbers;
-  unordered_map<int, vector<int>> occurrence_map;
-
-  vector<string> const lines = LoadLinesFromFile(path);
+  vector<int> starting_numbers;
 
-  for (string token : Split(lines.at(0), ','))
   {
-    starting_numbers.push_back(0);
-    stringstream(token) >> starting_numbers.back();
+    TimeScope t("Parse");
+    starting_numbers = LoadStartingNumbers(LoadLinesFromFile(path));
   }
 
-  for (int turn = 0; turn < target_turn; turn++)
-  {
-    int const previous_number = sequence.size() > 0 ? sequence.back() : 0;
-    int next_number = 0;
-
-    if (turn < starting_numbers.size())
-    {
-      next_number = starting_numbers.at(turn);
-    }
-    else
-    {
-      if (occurrence_map.find(previous_number) != occurrence_map.end())
-      {
-        vector<int> const& occurrences = occurrence_map.at(previous_number);
-
-        if (occurrences.size() > 1)
-        {
-          next_number = occurrences.back() - occurrences.at(occurrences.size() - 2);
-        }
-      }
-    }
-
-    occurrence_map[next_number].push_back(turn);
-    sequence.push_back(next_number);
-  }
+  TimeScope t("Solve");
 
-  cout << sequence.back() << endl;
+  cout << NumberSpokenOnTurn(starting_numbers, target_turn) << endl;
 
   return 0;
 }
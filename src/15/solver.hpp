@@ -0,0 +1,86 @@
+#ifndef DAY15_SOLVER_INCLUDED
+#define DAY15_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "stringutil.hpp"
+#include "timescope.hpp"
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <unordered_map>
+
+
+namespace day15
+{
+
+
+using namespace std;
+
+
+inline vector<int> LoadStartingNumbers(LineList const& lines)
+{
+  vector<int> starting_numbers;
+
+  for (auto const token : Split(lines.at(0), ','))
+  {
+    starting_numbers.push_back(StringToInt(token));
+  }
+
+  return starting_numbers;
+}
+
+
+inline int NumberSpokenOnTurn(vector<int> const& starting_numbers, int const target_turn)
+{
+  vector<int> sequence;
+  unordered_map<int, vector<int>> occurrence_map;
+
+  for (int turn = 0; turn < target_turn; turn++)
+  {
+    int const previous_number = sequence.size() > 0 ? sequence.back() : 0;
+    int next_number = 0;
+
+    if (turn < starting_numbers.size())
+    {
+      next_number = starting_numbers.at(turn);
+    }
+    else
+    {
+      if (occurrence_map.find(previous_number) != occurrence_map.end())
+      {
+        vector<int> const& occurrences = occurrence_map.at(previous_number);
+
+        if (occurrences.size() > 1)
+        {
+          next_number = occurrences.back() - occurrences.at(occurrences.size() - 2);
+        }
+      }
+    }
+
+    occurrence_map[next_number].push_back(turn);
+    sequence.push_back(next_number);
+  }
+
+  return sequence.back();
+}
+
+
+// Only the default turn, the 30 million turn version is far too slow for a
+// routine run with this representation
+inline string Solve(string_view const input)
+{
+  vector<int> const starting_numbers = LoadStartingNumbers(LineList(input));
+  stringstream ss;
+
+  ss << "turn 2020: " << NumberSpokenOnTurn(starting_numbers, 2020) << endl;
+
+  return ss.str();
+}
+
+
+} // namespace day15
+
+
+#endif // DAY15_SOLVER_INCLUDED
@@ -0,0 +1,310 @@
+#ifndef DAY16_SOLVER_INCLUDED
+#define DAY16_SOLVER_INCLUDED
+
+#include "loadlines.hpp"
+#include "stringutil.hpp"
+#include "timescope.hpp"
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <iostream>
+#include <set>
+#include <cstdint>
+
+
+namespace day16
+{
+
+
+using namespace std;
+
+
+struct Range
+{
+  int min = 0;
+  int max = 0;
+
+  Range(int const min, int const max) :
+    min(min), max(max)
+  {}
+
+  Range(string_view const token)
+  {
+    auto const [min_str, max_str] = SplitOnce(token, '-');
+    min = StringToInt(min_str);
+    max = StringToInt(max_str);
+  }
+
+  bool Contains(int const n) const
+  {
+    return n <= max && n >= min;
+  }
+};
+
+
+inline bool RangesContain(vector<Range> const ranges, int const value)
+{
+  for (Range const range : ranges)
+  {
+    if (range.Contains(value))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+struct Ticket
+{
+  vector<int> field_values;
+
+  Ticket(string_view const line)
+  {
+    for (auto const token : Split(line, ','))
+    {
+      field_values.push_back(StringToInt(token));
+    }
+  }
+
+  int InvalidFieldChecksum(map<string, vector<Range>> const field_constraints) const
+  {
+    int checksum = 0;
+
+    for (int const field_value : field_values)
+    {
+      bool valid = false;
+
+      for (auto const [name, ranges] : field_constraints)
+      {
+        if (RangesContain(ranges, field_value))
+        {
+          valid = true;
+          break;
+        }
+      }
+
+      if (!valid)
+      {
+        checksum += field_value;
+      }
+    }
+
+    return checksum;
+  }
+};
+
+
+typedef map<string, vector<Range>> FieldConstraints;
+
+
+// The three sections of the notes are read in order, with line tracking
+// the current position in the list.
+inline FieldConstraints LoadFieldConstraints(LineList const& lines, size_t& line)
+{
+  FieldConstraints field_constraints;
+
+  for (; line < lines.size() && lines[line] != ""; line++)
+  {
+    auto const [name, ranges_str] = SplitOnce(lines[line], ':');
+
+    // "<min>-<max> or <min>-<max>"
+    auto range_token = Split(trim(ranges_str), ' ').begin();
+
+    vector<Range>& ranges = field_constraints[string(trim(name))];
+    ranges.push_back(Range(*range_token++));
+    range_token++;
+    ranges.push_back(Range(*range_token));
+  }
+
+  line++;
+
+  return field_constraints;
+}
+
+
+inline Ticket LoadMyTicket(LineList const& lines, size_t& line)
+{
+  if (line + 2 >= lines.size() || lines[line] != "your ticket:")
+  {
+    cerr << "Malformed input, expected 'your ticket:'." << endl;
+    exit(1);
+  }
+
+  Ticket ticket(lines[line + 1]);
+
+  if (lines[line + 2] != "")
+  {
+    cerr << "Malformed input, expected empty line." << endl;
+    exit(1);
+  }
+
+  line += 3;
+
+  return ticket;
+}
+
+
+inline vector<Ticket> LoadNearbyTickets(LineList const& lines, size_t& line)
+{
+  if (line >= lines.size() || lines[line] != "nearby tickets:")
+  {
+    cerr << "Malformed input, expected 'nearby tickets:'." << endl;
+    exit(1);
+  }
+
+  vector<Ticket> tickets;
+
+  for (line++; line < lines.size(); line++)
+  {
+    tickets.push_back(Ticket(lines[line]));
+  }
+
+  return tickets;
+}
+
+
+struct Notes
+{
+  FieldConstraints field_constraints;
+  Ticket my_ticket;
+  vector<Ticket> nearby_tickets;
+};
+
+
+inline Notes LoadNotes(LineList const& lines)
+{
+  size_t line = 0;
+
+  auto field_constraints = LoadFieldConstraints(lines, line);
+  auto my_ticket = LoadMyTicket(lines, line);
+  auto nearby_tickets = LoadNearbyTickets(lines, line);
+
+  return {field_constraints, my_ticket, nearby_tickets};
+}
+
+
+// Fills in valid_tickets and returns the sum of all invalid field values
+inline int ScanTickets(
+  Notes const& notes,
+  vector<Ticket>& valid_tickets)
+{
+  int checksum = 0;
+
+  for (Ticket const& ticket : notes.nearby_tickets)
+  {
+    int invalid_field_checksum = ticket.InvalidFieldChecksum(notes.field_constraints);
+
+    if (invalid_field_checksum == 0)
+    {
+      valid_tickets.push_back(ticket);
+    }
+
+    checksum += invalid_field_checksum;
+  }
+
+  return checksum;
+}
+
+
+// Works out which field is which, and returns the values from my ticket
+inline map<string, int> IdentifyFields(
+  Notes const& notes,
+  vector<Ticket> const& valid_tickets)
+{
+  map<string, set<int>> valid_field_mappings;
+
+  for (unsigned i = 0; i < notes.my_ticket.field_values.size(); i++)
+  {
+    for (auto const& [name, ranges] : notes.field_constraints)
+    {
+      bool match = true;
+
+      for (Ticket const& ticket : valid_tickets)
+      {
+        if (!RangesContain(ranges, ticket.field_values.at(i)))
+        {
+          match = false;
+          break;
+        }
+      }
+
+      if (match)
+      {
+        valid_field_mappings[name].insert(i);
+      }
+    }
+  }
+
+  map<string, int> my_ticket_fields;
+
+  while (valid_field_mappings.size() > 0)
+  {
+    bool assignment_made = false;
+
+    for (auto const [name, valid_indices] : valid_field_mappings)
+    {
+      if (valid_indices.size() == 1)
+      {
+        int const i = *valid_indices.begin();
+        my_ticket_fields[name] = notes.my_ticket.field_values.at(i);
+
+        valid_field_mappings.erase(name);
+
+        for (auto& [name, valid_indices] : valid_field_mappings)
+        {
+          valid_indices.erase(i);
+        }
+
+        assignment_made = true;
+        break;
+      }
+    }
+
+    if (!assignment_made)
+    {
+      break;
+    }
+  }
+
+  return my_ticket_fields;
+}
+
+
+inline uint64_t DepartureChecksum(map<string, int> const& my_ticket_fields)
+{
+  uint64_t departure_checksum = 1;
+
+  for (auto const& [field_name, field_value] : my_ticket_fields)
+  {
+    if (field_name.find("departure") == 0)
+    {
+      departure_checksum *= field_value;
+    }
+  }
+
+  return departure_checksum;
+}
+
+
+inline string Solve(string_view const input)
+{
+  Notes const notes = LoadNotes(LineList(input));
+  vector<Ticket> valid_tickets;
+  stringstream ss;
+
+  ss << "Invalid field checksum: " << ScanTickets(notes, valid_tickets) << endl;
+  ss << "Departure checksum: " << DepartureChecksum(IdentifyFields(notes, valid_tickets)) << endl;
+
+  return ss.str();
+}
+
+
+} // namespace day16
+
+
+#endif // DAY16_SOLVER_INCLUDED
@@ -0,0 +1,412 @@
+#include "../solvers.hpp"
+#include "../generators.hpp"
+
+#include "mappedfile.hpp"
+#include "stringutil.hpp"
+
+#include "docopt/docopt.h"
+
+#include <set>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+
+using namespace std;
+
+
+static const char USAGE[] =
+R"(Benchmark harness for every day's solver
+
+Runs each solver over its bundled input, plus any extra inputs given as
+<day>=<path> (e.g. 01=big_numbers), and reports timing statistics. With
+--scale, each solver also gets a generated input that many times the size
+of its bundled one.
+
+Usage:
+  a.out [options] [<input>...]
+  a.out (-h | --help)
+
+Options:
+  -h --help                 Print this help message.
+  -d --days <days>          Comma separated list of days to run, or all. [default: all]
+  -w --warmup <count>       Untimed runs before measuring. [default: 3]
+  -r --repetitions <count>  Timed runs per input. [default: 20]
+  --root <dir>              Directory holding the day directories. [default: ..]
+  --no-bundled              Only run the extra inputs.
+  --scale <factor>          Also run generated inputs, scaled from the bundled size.
+  --seed <seed>             Seed for generated inputs. [default: 2020]
+  --json <path>             Also write the results to a JSON file.
+)";
+
+
+// Either a file, or an input to generate (when generator is set)
+struct BenchInput
+{
+  Solver const* solver;
+  string path;
+  Generator const* generator = nullptr;
+  size_t size = 0;
+  uint64_t seed = 0;
+};
+
+
+struct BenchResult
+{
+  string name;
+  string path;
+  size_t bytes = 0;
+  vector<double> seconds;
+  bool consistent = true;
+  string output;
+
+  double Min() const { return *min_element(seconds.begin(), seconds.end()); }
+  double Max() const { return *max_element(seconds.begin(), seconds.end()); }
+
+  double Mean() const
+  {
+    double sum = 0;
+
+    for (double const s : seconds)
+    {
+      sum += s;
+    }
+
+    return sum / seconds.size();
+  }
+
+  double Median() const
+  {
+    vector<double> sorted = seconds;
+    sort(sorted.begin(), sorted.end());
+
+    size_t const mid = sorted.size() / 2;
+    return (sorted.size() % 2 == 1) ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+  }
+
+  double StdDev() const
+  {
+    if (seconds.size() < 2)
+    {
+      return 0;
+    }
+
+    double const mean = Mean();
+    double sum = 0;
+
+    for (double const s : seconds)
+    {
+      sum += (s - mean) * (s - mean);
+    }
+
+    return sqrt(sum / (seconds.size() - 1));
+  }
+
+  // Input bytes per second, at the median time
+  double Throughput() const
+  {
+    return bytes / Median();
+  }
+};
+
+
+// Every day's solver, each followed by any variants of it which are only
+// worth benching: day 01 with four and five numbers (01k4, 01k5), and with
+// four over 01w's wide ranging values (01w4, which has no bundled input,
+// only generated ones).
+vector<Solver> const& BenchSolvers()
+{
+  static vector<Solver> const solvers = []
+  {
+    vector<Solver> const variants = {
+      {"01k4", "01/numbers", [](string_view const input) { return day01::SolveCounts(input, 4, 4); }},
+      {"01k5", "01/numbers", [](string_view const input) { return day01::SolveCounts(input, 5, 5); }},
+      {"01w4", "", [](string_view const input) { return day01::SolveCounts(input, 4, 4); }}
+    };
+
+    vector<Solver> all;
+
+    for (Solver const& solver : Solvers())
+    {
+      all.push_back(solver);
+
+      for (Solver const& variant : variants)
+      {
+        if (variant.name.compare(0, solver.name.size(), solver.name) == 0)
+        {
+          all.push_back(variant);
+        }
+      }
+    }
+
+    return all;
+  }();
+
+  return solvers;
+}
+
+
+Solver const* RequireSolver(string_view const name)
+{
+  for (Solver const& solver : BenchSolvers())
+  {
+    if (solver.name == name)
+    {
+      return &solver;
+    }
+  }
+
+  cerr << "No solver for day '" << name << "'" << endl;
+  exit(1);
+}
+
+
+BenchResult Run(BenchInput const& input, unsigned const warmup, unsigned const repetitions)
+{
+  unique_ptr<MappedFile const> file;
+  string generated;
+  string_view view;
+
+  if (input.generator != nullptr)
+  {
+    stringstream ss;
+    Random random(input.seed);
+
+    input.generator->generate(ss, input.size, random);
+    generated = ss.str();
+    view = generated;
+  }
+  else
+  {
+    file = make_unique<MappedFile const>(input.path);
+    view = file->View();
+  }
+
+  BenchResult result;
+  result.name = input.solver->name;
+  result.path = input.path;
+  result.bytes = view.size();
+
+  for (unsigned i = 0; i < warmup; i++)
+  {
+    result.output = input.solver->solve(view);
+  }
+
+  for (unsigned i = 0; i < repetitions; i++)
+  {
+    auto const t_start = chrono::steady_clock::now();
+    string const output = input.solver->solve(view);
+    auto const t_end = chrono::steady_clock::now();
+
+    result.seconds.push_back(chrono::duration<double>(t_end - t_start).count());
+
+    // Every run should agree, otherwise the timings mean nothing
+    if (result.output.empty())
+    {
+      result.output = output;
+    }
+    else if (output != result.output)
+    {
+      result.consistent = false;
+    }
+  }
+
+  return result;
+}
+
+
+string JsonEscape(string_view const str)
+{
+  string escaped;
+
+  for (char const c : str)
+  {
+    if (c == '"' || c == '\\')
+    {
+      escaped += '\\';
+      escaped += c;
+    }
+    else if (c == '\n')
+    {
+      escaped += "\\n";
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      char buffer[8];
+      snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+      escaped += buffer;
+    }
+    else
+    {
+      escaped += c;
+    }
+  }
+
+  return escaped;
+}
+
+
+void WriteJson(string const& path, vector<BenchResult> const& results, unsigned const warmup, unsigned const repetitions)
+{
+  ofstream ofs(path);
+
+  if (!ofs)
+  {
+    cerr << "Could not open " << path << " for writing" << endl;
+    exit(1);
+  }
+
+  ofs << "{\n"
+      << "  \"warmup\": " << warmup << ",\n"
+      << "  \"repetitions\": " << repetitions << ",\n"
+      << "  \"results\": [";
+
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    BenchResult const& result = results[i];
+
+    ofs << (i > 0 ? "," : "") << "\n    {"
+        << "\"day\": \"" << JsonEscape(result.name) << "\", "
+        << "\"input\": \"" << JsonEscape(result.path) << "\", "
+        << "\"bytes\": " << result.bytes << ", "
+        << "\"min_s\": " << result.Min() << ", "
+        << "\"median_s\": " << result.Median() << ", "
+        << "\"mean_s\": " << result.Mean() << ", "
+        << "\"stddev_s\": " << result.StdDev() << ", "
+        << "\"max_s\": " << result.Max() << ", "
+        << "\"bytes_per_s\": " << result.Throughput() << ", "
+        << "\"consistent\": " << (result.consistent ? "true" : "false") << ", "
+        << "\"output\": \"" << JsonEscape(result.output) << "\"}";
+  }
+
+  ofs << (results.empty() ? "" : "\n  ") << "]\n}\n";
+}
+
+
+int main(int argc, char **argv)
+{
+  auto args = docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
+
+  unsigned const warmup = args["--warmup"].asLong();
+  unsigned const repetitions = args["--repetitions"].asLong();
+  string const root = args["--root"].asString();
+  string const days = args["--days"].asString();
+
+  if (repetitions == 0)
+  {
+    cerr << "Need at least one repetition" << endl;
+    exit(1);
+  }
+
+  set<string> selected;
+
+  for (auto const day : Split(days, ','))
+  {
+    if (day != "all")
+    {
+      selected.insert(string(RequireSolver(day)->name));
+    }
+  }
+
+  auto const Selected = [&](Solver const& solver)
+  {
+    return selected.empty() || selected.count(solver.name) > 0;
+  };
+
+  vector<BenchInput> inputs;
+
+  if (!args["--no-bundled"].asBool())
+  {
+    for (Solver const& solver : BenchSolvers())
+    {
+      if (Selected(solver) && !solver.input.empty())
+      {
+        inputs.push_back({&solver, root + "/" + solver.input});
+      }
+    }
+  }
+
+  if (args["<input>"])
+  {
+    for (string const& spec : args["<input>"].asStringList())
+    {
+      auto const [day, path] = SplitOnce(spec, '=');
+
+      if (path.empty())
+      {
+        cerr << "Expected <day>=<path>, got '" << spec << "'" << endl;
+        exit(1);
+      }
+
+      Solver const* const solver = RequireSolver(day);
+
+      if (Selected(*solver))
+      {
+        inputs.push_back({solver, string(path)});
+      }
+    }
+  }
+
+  if (args["--scale"])
+  {
+    double const factor = stod(args["--scale"].asString());
+    uint64_t const seed = stoull(args["--seed"].asString());
+
+    for (Solver const& solver : BenchSolvers())
+    {
+      // Variants of a day use the generator with the longest name they start
+      // with, so 01k4 uses 01's and 01w4 uses 01w's
+      Generator const* chosen = nullptr;
+
+      for (Generator const& generator : Generators())
+      {
+        if (solver.name.compare(0, generator.name.size(), generator.name) == 0 &&
+            (chosen == nullptr || generator.name.size() > chosen->name.size()))
+        {
+          chosen = &generator;
+        }
+      }
+
+      if (chosen == nullptr || !Selected(solver))
+      {
+        continue;
+      }
+
+      size_t const size = chosen->ScaledSize(factor);
+      inputs.push_back({&solver, "generated(size=" + to_string(size) + ")", chosen, size, seed});
+    }
+  }
+
+  vector<BenchResult> results;
+
+  printf("%-5s %-32s %10s %12s %12s %12s %12s %12s %10s\n",
+    "day", "input", "bytes", "min (ms)", "median (ms)", "mean (ms)", "stddev (ms)", "max (ms)", "MB/s");
+
+  for (BenchInput const& input : inputs)
+  {
+    results.push_back(Run(input, warmup, repetitions));
+
+    BenchResult const& result = results.back();
+
+    printf("%-5s %-32s %10zu %12.4f %12.4f %12.4f %12.4f %12.4f %10.1f%s\n",
+      result.name.c_str(), result.path.c_str(), result.bytes,
+      result.Min() * 1e3, result.Median() * 1e3, result.Mean() * 1e3,
+      result.StdDev() * 1e3, result.Max() * 1e3, result.Throughput() / 1e6,
+      result.consistent ? "" : "  (inconsistent output!)");
+  }
+
+  if (args["--json"])
+  {
+    WriteJson(args["--json"].asString(), results, warmup, repetitions);
+  }
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include "../solvers.hpp"
+
+#include "mappedfile.hpp"
+#include "stringutil.hpp"
+#include "threadpool.hpp"
+
+#include "docopt/docopt.h"
+
+#include <map>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <future>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+
+using namespace std;
+
+
+static const char USAGE[] =
+R"(Runs every day's solver in one process
+
+Days run concurrently on a pool of threads, and their answers are printed
+in day order along with how long each one took. A day's bundled input can
+be replaced by giving <day>=<path> (e.g. 01=big_numbers).
+
+Usage:
+  a.out [options] [<input>...]
+  a.out (-h | --help)
+
+Options:
+  -h --help             Print this help message.
+  -d --days <days>      Comma separated list of days to run, or all. [default: all]
+  -j --threads <count>  Number of worker threads, 0 for one per core. [default: 0]
+  --root <dir>          Directory holding the day directories. [default: ..]
+)";
+
+
+struct DayResult
+{
+  string output;
+  double seconds;
+};
+
+
+int main(int argc, char **argv)
+{
+  auto args = docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
+
+  string const root = args["--root"].asString();
+  string const days = args["--days"].asString();
+  unsigned const threads = ThreadCount(args["--threads"].asLong());
+
+  map<string, string> paths;
+
+  for (auto const day : Split(days, ','))
+  {
+    Solver const* const solver = FindSolver(day);
+
+    if (day != "all" && solver == nullptr)
+    {
+      cerr << "No solver for day '" << day << "'" << endl;
+      exit(1);
+    }
+
+    for (Solver const& s : Solvers())
+    {
+      if (day == "all" || &s == solver)
+      {
+        paths[s.name] = root + "/" + s.input;
+      }
+    }
+  }
+
+  if (args["<input>"])
+  {
+    for (string const& spec : args["<input>"].asStringList())
+    {
+      auto const [day, path] = SplitOnce(spec, '=');
+
+      if (FindSolver(day) == nullptr || path.empty())
+      {
+        cerr << "Expected <day>=<path> for a day with a solver, got '" << spec << "'" << endl;
+        exit(1);
+      }
+
+      paths[string(day)] = path;
+    }
+  }
+
+  auto const t_start = chrono::steady_clock::now();
+
+  MappedFileCache files;
+  vector<pair<string, future<DayResult>>> results;
+
+  {
+    ThreadPool pool(threads);
+
+    for (auto const& [name, path] : paths)
+    {
+      Solver const* const solver = FindSolver(name);
+
+      results.emplace_back(name, pool.Submit([solver, path = path, &files]
+      {
+        auto const file = files.Get(path);
+
+        auto const t_solve = chrono::steady_clock::now();
+        string output = solver->solve(file->View());
+        chrono::duration<double> const elapsed = chrono::steady_clock::now() - t_solve;
+
+        return DayResult{move(output), elapsed.count()};
+      }));
+    }
+
+    double total = 0;
+
+    for (auto& [name, result] : results)
+    {
+      DayResult const day = result.get();
+      total += day.seconds;
+
+      printf("== Day %s (%.3f ms)\n", name.c_str(), day.seconds * 1e3);
+      cout << day.output << flush;
+    }
+
+    chrono::duration<double> const elapsed = chrono::steady_clock::now() - t_start;
+
+    printf("== %zu days on %zu threads: %.3f ms wall, %.3f ms total\n",
+      results.size(), pool.Size(), elapsed.count() * 1e3, total * 1e3);
+  }
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include "../generators.hpp"
+
+#include "docopt/docopt.h"
+
+#include <string>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+
+using namespace std;
+
+
+static const char USAGE[] =
+R"(Synthetic puzzle input generator
+
+Writes an input for <day> to stdout. What <size> means depends on the day:
+usually it is a count of lines or records, but for the grid days (03 and 11)
+it is the side length. Use --list to see the size of each bundled input, or
+--scale to ask for a multiple of it instead of giving <size>.
+
+Usage:
+  a.out [options] <day> [<size>]
+  a.out --list
+  a.out (-h | --help)
+
+Options:
+  -h --help             Print this help message.
+  -l --list             List the days which have a generator.
+  -s --seed <seed>      Seed for the random number generator. [default: 2020]
+  -x --scale <factor>   Size relative to the bundled input.
+  -o --output <path>    Write to a file instead of stdout.
+)";
+
+
+int main(int argc, char **argv)
+{
+  auto args = docopt::docopt(USAGE, {argv + 1, argv + argc}, true);
+
+  if (args["--list"].asBool())
+  {
+    for (Generator const& generator : Generators())
+    {
+      cout << generator.name << " (bundled input size " << generator.base_size << ")" << endl;
+    }
+
+    return 0;
+  }
+
+  string const day = args["<day>"].asString();
+  Random random(stoull(args["--seed"].asString()));
+
+  if (!args["<size>"] && !args["--scale"])
+  {
+    cerr << "Need either <size> or --scale" << endl;
+    exit(1);
+  }
+
+  for (Generator const& generator : Generators())
+  {
+    if (generator.name == day)
+    {
+      size_t const size = args["<size>"] ?
+        stoull(args["<size>"].asString()) :
+        generator.ScaledSize(stod(args["--scale"].asString()));
+
+      if (args["--output"])
+      {
+        string const path = args["--output"].asString();
+        ofstream ofs(path);
+
+        if (!ofs)
+        {
+          cerr << "Could not open " << path << " for writing" << endl;
+          exit(1);
+        }
+
+        generator.generate(ofs, size, random);
+      }
+      else
+      {
+        ios::sync_with_stdio(false);
+        generator.generate(cout, size, random);
+      }
+
+      return 0;
+    }
+  }
+
+  cerr << "No generator for day '" << day << "'" << endl;
+  exit(1);
+}
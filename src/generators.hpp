@@ -0,0 +1,1094 @@
+#ifndef GENERATORS_INCLUDED
+#define GENERATORS_INCLUDED
+
+#include "random.hpp"
+
+#include <set>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <algorithm>
+#include <functional>
+
+
+// Synthetic puzzle inputs of any size, for measuring how the solvers scale.
+// Every generator is deterministic for a given seed, and produces input which
+// has an answer in the same sense as the real puzzle input (e.g. exactly one
+// pair of numbers adds to 2020, exactly one instruction needs repairing).
+namespace generate
+{
+
+
+using namespace std;
+
+
+inline string Signed(int64_t const n)
+{
+  return (n < 0 ? "-" : "+") + to_string(n < 0 ? -n : n);
+}
+
+
+// <size> numbers, exactly one pair and one triple of which add to 2020
+inline void Day01(ostream& os, size_t const size, Random& random)
+{
+  vector<int> planted;
+
+  auto const PlantedSums = [&](unsigned const count)
+  {
+    unsigned sums = 0;
+
+    for (unsigned i = 0; i < planted.size(); i++)
+    {
+      for (unsigned j = i + 1; j < planted.size(); j++)
+      {
+        if (count == 2)
+        {
+          sums += planted[i] + planted[j] == 2020;
+          continue;
+        }
+
+        for (unsigned k = j + 1; k < planted.size(); k++)
+        {
+          sums += planted[i] + planted[j] + planted[k] == 2020;
+        }
+      }
+    }
+
+    return sums;
+  };
+
+  do
+  {
+    int const a = random.Between(1011, 1900);
+    int const b = random.Between(100, 900);
+    int const c = random.Between(100, 1919 - b);
+
+    planted = {a, 2020 - a, b, c, 2020 - b - c};
+  }
+  while (set<int>(planted.begin(), planted.end()).size() != planted.size() ||
+         PlantedSums(2) != 1 || PlantedSums(3) != 1);
+
+  // Filler is over 1010, so it can only make 2020 along with planted values
+  set<int> forbidden;
+
+  for (unsigned i = 0; i < planted.size(); i++)
+  {
+    forbidden.insert(2020 - planted[i]);
+
+    for (unsigned j = i + 1; j < planted.size(); j++)
+    {
+      forbidden.insert(2020 - planted[i] - planted[j]);
+    }
+  }
+
+  vector<int> numbers = planted;
+
+  while (numbers.size() < size)
+  {
+    int const filler = random.Between(1011, 2019);
+
+    if (forbidden.count(filler) == 0)
+    {
+      numbers.push_back(filler);
+    }
+  }
+
+  random.Shuffle(numbers);
+
+  for (int const n : numbers)
+  {
+    os << n << '\n';
+  }
+}
+
+
+// <size> distinct numbers spread over a wide range. They are all multiples
+// of 3, which 2020 is not, so no combination of them adds up to it and a
+// search has to rule out every one.
+inline void Day01Wide(ostream& os, size_t const size, Random& random)
+{
+  set<int> distinct;
+
+  while (distinct.size() < size)
+  {
+    distinct.insert(3 * random.Between(-300000000, 300000000));
+  }
+
+  vector<int> numbers(distinct.begin(), distinct.end());
+  random.Shuffle(numbers);
+
+  for (int const n : numbers)
+  {
+    os << n << '\n';
+  }
+}
+
+
+// <size> password policy lines
+inline void Day02(ostream& os, size_t const size, Random& random)
+{
+  for (size_t i = 0; i < size; i++)
+  {
+    int const min = random.Between(1, 10);
+    int const max = random.Between(min + 1, 20);
+    char const c = 'a' + random.Below(26);
+
+    os << min << '-' << max << ' ' << c << ": ";
+
+    // Long enough for both positions to exist
+    int const length = random.Between(max, max + 6);
+
+    for (int j = 0; j < length; j++)
+    {
+      os << (random.Chance(2, 5) ? c : static_cast<char>('a' + random.Below(26)));
+    }
+
+    os << '\n';
+  }
+}
+
+
+// <size> by <size> map of trees
+inline void Day03(ostream& os, size_t const size, Random& random)
+{
+  string row(size, '.');
+
+  for (size_t y = 0; y < size; y++)
+  {
+    for (size_t x = 0; x < size; x++)
+    {
+      row[x] = random.Chance(1, 5) ? '#' : '.';
+    }
+
+    os << row << '\n';
+  }
+}
+
+
+// <size> passports, some with missing fields and some with invalid values
+inline void Day04(ostream& os, size_t const size, Random& random)
+{
+  vector<string> const eye_colours = {"amb", "blu", "brn", "gry", "grn", "hzl", "oth"};
+  vector<string> const bad_eye_colours = {"xry", "zzz", "gmt", "lzr", "#a97842"};
+  string const hex_chars = "0123456789abcdef";
+
+  auto const Digits = [&](unsigned const count)
+  {
+    string digits;
+
+    for (unsigned i = 0; i < count; i++)
+    {
+      digits += '0' + random.Below(10);
+    }
+
+    return digits;
+  };
+
+  auto const Year = [&](int const min, int const max, bool const valid)
+  {
+    if (valid)
+    {
+      return to_string(random.Between(min, max));
+    }
+
+    return random.Chance(1, 4) ? Digits(2) : to_string(random.Chance(1, 2) ? min - random.Between(1, 20) : max + random.Between(1, 20));
+  };
+
+  for (size_t i = 0; i < size; i++)
+  {
+    vector<string> fields;
+
+    auto const Valid = [&]()
+    {
+      return random.Chance(17, 20);
+    };
+
+    fields.push_back("byr:" + Year(1920, 2002, Valid()));
+    fields.push_back("iyr:" + Year(2010, 2020, Valid()));
+    fields.push_back("eyr:" + Year(2020, 2030, Valid()));
+
+    if (Valid())
+    {
+      fields.push_back("hgt:" + (random.Chance(1, 2) ?
+        to_string(random.Between(150, 193)) + "cm" :
+        to_string(random.Between(59, 76)) + "in"));
+    }
+    else
+    {
+      fields.push_back("hgt:" + to_string(random.Between(50, 200)) + (random.Chance(1, 2) ? "in" : ""));
+    }
+
+    string hair_colour;
+
+    for (unsigned j = 0; j < 6; j++)
+    {
+      hair_colour += hex_chars[random.Below(hex_chars.size())];
+    }
+
+    if (Valid())
+    {
+      fields.push_back("hcl:#" + hair_colour);
+    }
+    else
+    {
+      fields.push_back("hcl:" + (random.Chance(1, 2) ? hair_colour : "#" + hair_colour.substr(0, 5) + "z"));
+    }
+
+    fields.push_back("ecl:" + (Valid() ? random.Pick(eye_colours) : random.Pick(bad_eye_colours)));
+    fields.push_back("pid:" + Digits(Valid() ? 9 : random.Chance(1, 2) ? 8 : 10));
+    fields.push_back("cid:" + to_string(random.Between(50, 350)));
+
+    // Country is optional, anything else missing makes the passport invalid
+    if (random.Chance(1, 2))
+    {
+      fields.pop_back();
+    }
+
+    if (random.Chance(1, 5))
+    {
+      fields.erase(fields.begin() + random.Below(fields.size()));
+    }
+
+    random.Shuffle(fields);
+
+    if (i > 0)
+    {
+      os << '\n';
+    }
+
+    for (size_t j = 0; j < fields.size(); j++)
+    {
+      os << fields[j] << (j + 1 == fields.size() ? '\n' : random.Chance(1, 3) ? '\n' : ' ');
+    }
+  }
+}
+
+
+// <size> boarding passes, for a block of consecutive seats with exactly one
+// free seat inside it. The plane only has 1024 seats, so past that passes
+// are repeated.
+inline void Day05(ostream& os, size_t const size, Random& random)
+{
+  size_t const count = max<size_t>(size, 2);
+  int const span = min<size_t>(count + 1, 1000);  // the free seat included
+  int const first = random.Between(1, 1023 - span);
+  int const missing = first + random.Between(1, span - 2);
+
+  vector<int> ids;
+
+  for (int id = first; id < first + span; id++)
+  {
+    if (id != missing)
+    {
+      ids.push_back(id);
+    }
+  }
+
+  while (ids.size() < count)
+  {
+    int const id = first + random.Below(span);
+
+    if (id != missing)
+    {
+      ids.push_back(id);
+    }
+  }
+
+  random.Shuffle(ids);
+
+  string pass(10, ' ');
+
+  for (int const id : ids)
+  {
+    for (int bit = 0; bit < 10; bit++)
+    {
+      bool const one = (id >> (9 - bit)) & 1;
+      pass[bit] = (bit < 7) ? (one ? 'B' : 'F') : (one ? 'R' : 'L');
+    }
+
+    os << pass << '\n';
+  }
+}
+
+
+// <size> groups of customs declaration answers
+inline void Day06(ostream& os, size_t const size, Random& random)
+{
+  for (size_t i = 0; i < size; i++)
+  {
+    uint32_t const common = random.Next() & random.Next() & ((1 << 26) - 1);
+    int const people = random.Between(1, 5);
+
+    if (i > 0)
+    {
+      os << '\n';
+    }
+
+    for (int j = 0; j < people; j++)
+    {
+      uint32_t answers = common | (random.Next() & random.Next() & random.Next() & ((1 << 26) - 1));
+
+      if (answers == 0)
+      {
+        answers = 1 << random.Below(26);
+      }
+
+      vector<char> letters;
+
+      for (char c = 'a'; c <= 'z'; c++)
+      {
+        if (answers & (1 << (c - 'a')))
+        {
+          letters.push_back(c);
+        }
+      }
+
+      random.Shuffle(letters);
+      os << string(letters.begin(), letters.end()) << '\n';
+    }
+  }
+}
+
+
+// Bag rules forming a DAG of <size> bags, one of which is shiny gold
+inline void Day07(ostream& os, size_t const size, Random& random)
+{
+  vector<string> const adjectives = {
+    "bright", "clear", "dark", "dim", "dotted", "drab", "dull", "faded", "light",
+    "mirrored", "muted", "pale", "plaid", "posh", "shiny", "striped", "vibrant", "wavy"};
+
+  vector<string> const colours = {
+    "aqua", "beige", "black", "blue", "bronze", "brown", "chartreuse", "coral", "crimson",
+    "cyan", "fuchsia", "gold", "gray", "green", "indigo", "lavender", "lime", "magenta",
+    "maroon", "olive", "orange", "plum", "purple", "red", "salmon", "silver", "tan",
+    "teal", "tomato", "turquoise", "violet", "white", "yellow"};
+
+  size_t const bags = max<size_t>(size, 2);
+
+  // Only the bags after shiny gold count towards part two, and there are few
+  // enough of them that the total stays well inside 64 bits
+  size_t const gold = bags - 1 - min<size_t>(bags - 1, 200);
+
+  auto const NaturalName = [&](size_t const i)
+  {
+    string adjective = adjectives[i % adjectives.size()];
+
+    // Once the combinations run out, make up some more adjectives
+    for (size_t k = i / (adjectives.size() * colours.size()); k > 0; k = (k - 1) / 26)
+    {
+      adjective += 'a' + (k - 1) % 26;
+    }
+
+    return adjective + " " + colours[(i / adjectives.size()) % colours.size()];
+  };
+
+  auto const Name = [&](size_t const i)
+  {
+    if (i == gold)
+    {
+      return string("shiny gold");
+    }
+
+    string const name = NaturalName(i);
+    return name == "shiny gold" ? NaturalName(gold) : name;
+  };
+
+  vector<size_t> order(bags);
+
+  for (size_t i = 0; i < bags; i++)
+  {
+    order[i] = i;
+  }
+
+  random.Shuffle(order);
+
+  for (size_t const i : order)
+  {
+    os << Name(i) << " bags contain ";
+
+    // Bags only contain bags further along, which keeps it acyclic
+    size_t const later = bags - 1 - i;
+    size_t const count = min<size_t>(later, i > gold ? random.Below(3) : i == gold ? random.Between(1, 4) : random.Below(5));
+
+    set<size_t> contents;
+
+    while (contents.size() < count)
+    {
+      contents.insert(i + 1 + random.Below(later));
+    }
+
+    // Otherwise hardly anything would end up holding shiny gold
+    if (i < gold && !contents.empty() && random.Chance(1, 10))
+    {
+      contents.insert(gold);
+    }
+
+    if (contents.empty())
+    {
+      os << "no other bags.\n";
+      continue;
+    }
+
+    size_t n = 0;
+
+    for (size_t const j : contents)
+    {
+      int const quantity = random.Between(1, i > gold ? 4 : 5);
+
+      os << quantity << ' ' << Name(j) << (quantity == 1 ? " bag" : " bags") << (++n == contents.size() ? ".\n" : ", ");
+    }
+  }
+}
+
+
+// Boot program of <size> instructions which loops, but terminates if
+// exactly one jmp or nop is flipped
+inline void Day08(ostream& os, size_t const size, Random& random)
+{
+  size_t const length = max<size_t>(size, 1);
+
+  vector<string> opcodes;
+  vector<int64_t> arguments;
+
+  // Instructions on the path the repaired program takes
+  vector<size_t> path;
+
+  while (opcodes.size() < length)
+  {
+    size_t const i = opcodes.size();
+    uint64_t const choice = random.Below(10);
+    int64_t const skip = random.Between(3, 8);
+
+    if (i == 0 || choice < 5 || (choice >= 7 && i + skip > length))
+    {
+      opcodes.push_back(i == 0 ? "nop" : "acc");
+      arguments.push_back(i == 0 ? 0 : random.Between(-50, 50));
+      path.push_back(i);
+    }
+    else if (choice < 7)
+    {
+      // Jumps back onto the path if flipped, so it would loop
+      opcodes.push_back("nop");
+      arguments.push_back(static_cast<int64_t>(random.Pick(path)) - static_cast<int64_t>(i));
+      path.push_back(i);
+    }
+    else
+    {
+      opcodes.push_back("jmp");
+      arguments.push_back(skip);
+      path.push_back(i);
+
+      // Skipped instructions all jump back onto the path, so flipping the jmp
+      // (or the first of these after that) loops
+      for (int64_t j = 1; j < skip; j++)
+      {
+        opcodes.push_back("jmp");
+        arguments.push_back(static_cast<int64_t>(random.Pick(path)) - static_cast<int64_t>(i + j));
+      }
+    }
+  }
+
+  // Break one instruction on the path
+  vector<size_t> flippable;
+
+  for (size_t const i : path)
+  {
+    if (opcodes[i] != "acc")
+    {
+      flippable.push_back(i);
+    }
+  }
+
+  size_t const corrupt = random.Pick(flippable);
+  opcodes[corrupt] = opcodes[corrupt] == "nop" ? "jmp" : "nop";
+
+  for (size_t i = 0; i < length; i++)
+  {
+    os << opcodes[i] << ' ' << Signed(arguments[i]) << '\n';
+  }
+}
+
+
+// <size> XMAS numbers (preamble of 25). Every number must be the sum of two
+// of the previous 25, so the numbers at least double every 25 lines and
+// there can only be a thousand or so before they overflow. The invalid
+// number comes after those, and anything beyond that is filler.
+inline void Day09(ostream& os, size_t const size, Random& random)
+{
+  size_t const window = 25;
+  size_t const length = max<size_t>(size, window + 2);
+
+  vector<uint64_t> preamble;
+
+  for (uint64_t i = 1; i <= 100; i++)
+  {
+    preamble.push_back(i);
+  }
+
+  random.Shuffle(preamble);
+
+  vector<uint64_t> sequence(preamble.begin(), preamble.begin() + window);
+
+  while (sequence.size() < min<size_t>(length - 1, 1000))
+  {
+    // Sums of the smallest values in the window grow the slowest
+    set<uint64_t> smallest(sequence.end() - window, sequence.end());
+    vector<uint64_t> candidates(smallest.begin(), next(smallest.begin(), min<size_t>(smallest.size(), 6)));
+
+    uint64_t const a = random.Pick(candidates);
+    uint64_t b = a;
+
+    while (b == a)
+    {
+      b = random.Pick(candidates);
+    }
+
+    if (a + b > (UINT64_C(1) << 60))
+    {
+      break;
+    }
+
+    sequence.push_back(a + b);
+  }
+
+  // The invalid number is the sum of a run early in the sequence, which is
+  // usually far smaller than any sum of two values at the end
+  set<uint64_t> const values(sequence.begin(), sequence.end());
+  uint64_t invalid;
+
+  auto const IsPairSum = [&](uint64_t const n)
+  {
+    for (size_t i = sequence.size() - window; i < sequence.size(); i++)
+    {
+      for (size_t j = i + 1; j < sequence.size(); j++)
+      {
+        if (sequence[i] != sequence[j] && sequence[i] + sequence[j] == n)
+        {
+          return true;
+        }
+      }
+    }
+
+    return false;
+  };
+
+  do
+  {
+    size_t const start = random.Below(sequence.size() / 2);
+    size_t const run = random.Between(2, 17);
+
+    invalid = 0;
+
+    for (size_t i = start; i < start + run && i < sequence.size(); i++)
+    {
+      invalid += sequence[i];
+    }
+  }
+  while (values.count(invalid) > 0 || IsPairSum(invalid));
+
+  sequence.push_back(invalid);
+
+  while (sequence.size() < length)
+  {
+    sequence.push_back(random.Between(1, INT64_C(1) << 40));
+  }
+
+  for (uint64_t const n : sequence)
+  {
+    os << n << '\n';
+  }
+}
+
+
+// <size> adapters, each 1 to 3 jolts above the one before when sorted. The
+// number of arrangements outgrows 64 bits after a few thousand adapters.
+inline void Day10(ostream& os, size_t const size, Random& random)
+{
+  vector<int> ratings;
+  int rating = 0;
+
+  for (size_t i = 0; i < size; i++)
+  {
+    uint64_t const choice = random.Below(10);
+    rating += choice < 6 ? 1 : choice < 7 ? 2 : 3;
+    ratings.push_back(rating);
+  }
+
+  random.Shuffle(ratings);
+
+  for (int const r : ratings)
+  {
+    os << r << '\n';
+  }
+}
+
+
+// Applies the seating rules until nothing changes. Random seat maps can get
+// stuck flipping between two states forever, in which case this returns
+// false and changed holds the seats which were still flipping.
+inline bool SeatsSettle(vector<string> const& map, bool const visible, vector<size_t>& changed)
+{
+  size_t const height = map.size();
+  size_t const width = map[0].size();
+  size_t const none = SIZE_MAX;
+  unsigned const threshold = visible ? 5 : 4;
+
+  // Eight neighbours per cell, the nearest seat in each direction
+  vector<size_t> neighbours(height * width * 8, none);
+
+  for (size_t y = 0; y < height; y++)
+  {
+    for (size_t x = 0; x < width; x++)
+    {
+      size_t n = (y * width + x) * 8;
+
+      for (int dy = -1; dy <= 1; dy++)
+      {
+        for (int dx = -1; dx <= 1; dx++)
+        {
+          if (dy == 0 && dx == 0)
+          {
+            continue;
+          }
+
+          size_t sy = y + dy;
+          size_t sx = x + dx;
+
+          // Unsigned wrap-around takes care of the top and left edges
+          while (visible && sy < height && sx < width && map[sy][sx] == '.')
+          {
+            sy += dy;
+            sx += dx;
+          }
+
+          if (sy < height && sx < width && map[sy][sx] == 'L')
+          {
+            neighbours[n] = sy * width + sx;
+          }
+
+          n++;
+        }
+      }
+    }
+  }
+
+  vector<uint8_t> previous(height * width, 0);
+  vector<uint8_t> current = previous;
+  vector<uint8_t> next = previous;
+
+  while (true)
+  {
+    bool updated = false;
+
+    for (size_t y = 0; y < height; y++)
+    {
+      for (size_t x = 0; x < width; x++)
+      {
+        size_t const cell = y * width + x;
+
+        if (map[y][x] != 'L')
+        {
+          continue;
+        }
+
+        unsigned occupied = 0;
+
+        for (size_t n = cell * 8; n < cell * 8 + 8; n++)
+        {
+          occupied += neighbours[n] != none && current[neighbours[n]];
+        }
+
+        next[cell] = current[cell] ? occupied < threshold : occupied == 0;
+        updated |= next[cell] != current[cell];
+      }
+    }
+
+    if (!updated)
+    {
+      return true;
+    }
+
+    if (next == previous)
+    {
+      changed.clear();
+
+      for (size_t cell = 0; cell < next.size(); cell++)
+      {
+        if (next[cell] != current[cell])
+        {
+          changed.push_back(cell);
+        }
+      }
+
+      return false;
+    }
+
+    previous.swap(current);
+    current.swap(next);
+  }
+}
+
+
+// <size> by <size> seat map. Seats which keep the rules from settling are
+// turned into floor until both sets of rules settle, which means simulating
+// the map a few times over, so big maps take a while.
+inline void Day11(ostream& os, size_t const size, Random& random)
+{
+  vector<string> map(size, string(size, '.'));
+
+  for (string& row : map)
+  {
+    for (char& c : row)
+    {
+      c = random.Chance(3, 4) ? 'L' : '.';
+    }
+  }
+
+  vector<size_t> changed;
+  bool settled = size == 0;
+
+  while (!settled)
+  {
+    settled = true;
+
+    for (bool const visible : {false, true})
+    {
+      while (!SeatsSettle(map, visible, changed))
+      {
+        settled = false;
+
+        for (size_t const cell : changed)
+        {
+          if (random.Chance(1, 2) || cell == changed.back())
+          {
+            map[cell / size][cell % size] = '.';
+          }
+        }
+      }
+    }
+  }
+
+  for (string const& row : map)
+  {
+    os << row << '\n';
+  }
+}
+
+
+// <size> navigation instructions
+inline void Day12(ostream& os, size_t const size, Random& random)
+{
+  for (size_t i = 0; i < size; i++)
+  {
+    uint64_t const choice = random.Below(10);
+
+    if (choice < 2)
+    {
+      os << (random.Chance(1, 2) ? 'L' : 'R') << (random.Chance(3, 4) ? 90 : random.Chance(1, 2) ? 180 : 270);
+    }
+    else if (choice < 6)
+    {
+      os << "NSEW"[random.Below(4)] << random.Between(1, 5);
+    }
+    else
+    {
+      os << 'F' << random.Between(1, 100);
+    }
+
+    os << '\n';
+  }
+}
+
+
+// Bus schedule with <size> entries. The ids are distinct primes, and only as
+// many as keep the aligned timestamp inside 64 bits; the rest are x.
+inline void Day13(ostream& os, size_t const size, Random& random)
+{
+  vector<uint64_t> primes;
+
+  for (uint64_t n = 11; n < 1000; n++)
+  {
+    bool prime = true;
+
+    for (uint64_t d = 2; d * d <= n && prime; d++)
+    {
+      prime = n % d != 0;
+    }
+
+    if (prime)
+    {
+      primes.push_back(n);
+    }
+  }
+
+  random.Shuffle(primes);
+
+  vector<uint64_t> ids;
+  uint64_t product = 1;
+
+  for (uint64_t const p : primes)
+  {
+    if (product > (UINT64_C(1) << 60) / p)
+    {
+      break;
+    }
+
+    ids.push_back(p);
+    product *= p;
+  }
+
+  size_t const length = max(size, ids.size());
+
+  // The first entry is always a bus, like the real thing
+  vector<size_t> positions(length - 1);
+
+  for (size_t i = 0; i < positions.size(); i++)
+  {
+    positions[i] = i + 1;
+  }
+
+  random.Shuffle(positions);
+  positions.resize(ids.size() - 1);
+  positions.push_back(0);
+
+  vector<string> entries(length, "x");
+
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    entries[positions[i]] = to_string(ids[i]);
+  }
+
+  os << random.Between(100000, 10000000) << '\n';
+
+  for (size_t i = 0; i < length; i++)
+  {
+    os << entries[i] << (i + 1 == length ? '\n' : ',');
+  }
+}
+
+
+// <size> lines of bitmask program, with at most 9 floating bits per mask
+inline void Day14(ostream& os, size_t const size, Random& random)
+{
+  size_t i = 0;
+
+  while (i < size)
+  {
+    string mask(36, '0');
+
+    for (char& c : mask)
+    {
+      c = random.Chance(1, 2) ? '1' : '0';
+    }
+
+    for (int64_t floating = random.Between(1, 9); floating > 0; floating--)
+    {
+      mask[random.Below(mask.size())] = 'X';
+    }
+
+    os << "mask = " << mask << '\n';
+    i++;
+
+    for (int64_t writes = random.Between(1, 6); writes > 0 && i < size; writes--, i++)
+    {
+      os << "mem[" << random.Below(65536) << "] = " << random.Below(UINT64_C(1) << 30) << '\n';
+    }
+  }
+}
+
+
+// <size> distinct starting numbers
+inline void Day15(ostream& os, size_t const size, Random& random)
+{
+  size_t const count = max<size_t>(size, 1);
+  vector<int> numbers(count * 2);
+
+  for (size_t i = 0; i < numbers.size(); i++)
+  {
+    numbers[i] = i;
+  }
+
+  random.Shuffle(numbers);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    os << numbers[i] << (i + 1 == count ? '\n' : ',');
+  }
+}
+
+
+// Ticket notes with <size> nearby tickets, about a quarter of them invalid.
+// Each field has a gap in its ranges which only it rules out; values from
+// those gaps are placed so that the fields can be worked out by elimination.
+inline void Day16(ostream& os, size_t const size, Random& random)
+{
+  vector<string> const names = {
+    "departure location", "departure station", "departure platform", "departure track",
+    "departure date", "departure time", "arrival location", "arrival station",
+    "arrival platform", "arrival track", "class", "duration", "price", "route", "row",
+    "seat", "train", "type", "wagon", "zone"};
+
+  size_t const fields = names.size();
+  size_t const tickets = max<size_t>(size, 40);
+
+  // Every field covers [50, 950] apart from its own gap of ten values
+  auto const GapStart = [](size_t const field)
+  {
+    return 100 + 40 * static_cast<int64_t>(field);
+  };
+
+  auto const ValidForAll = [&]()
+  {
+    while (true)
+    {
+      int64_t const value = random.Between(50, 950);
+
+      if (value < GapStart(0) || value >= GapStart(fields) || (value - GapStart(0)) % 40 >= 10)
+      {
+        return value;
+      }
+    }
+  };
+
+  for (size_t f = 0; f < fields; f++)
+  {
+    os << names[f] << ": " << random.Between(25, 49) << '-' << GapStart(f) - 1 << " or "
+       << GapStart(f) + 10 << '-' << random.Between(951, 975) << '\n';
+  }
+
+  // column_field[c] is the field in column c, and a field of rank r is
+  // consistent with exactly the columns whose field has a rank of r or less
+  vector<size_t> column_field(fields);
+  vector<size_t> rank(fields);
+
+  for (size_t i = 0; i < fields; i++)
+  {
+    column_field[i] = i;
+    rank[i] = i;
+  }
+
+  random.Shuffle(column_field);
+  random.Shuffle(rank);
+
+  vector<vector<int64_t>> nearby(tickets, vector<int64_t>(fields));
+  vector<bool> valid(tickets);
+  vector<size_t> valid_tickets;
+
+  for (size_t t = 0; t < tickets; t++)
+  {
+    valid[t] = t < 20 || random.Chance(3, 4);
+
+    for (int64_t& value : nearby[t])
+    {
+      value = ValidForAll();
+    }
+
+    if (valid[t])
+    {
+      valid_tickets.push_back(t);
+    }
+    else
+    {
+      nearby[t][random.Below(fields)] = random.Chance(1, 2) ? random.Between(1, 24) : random.Between(976, 999);
+    }
+  }
+
+  vector<vector<bool>> used(tickets, vector<bool>(fields));
+
+  for (size_t c = 0; c < fields; c++)
+  {
+    for (size_t f = 0; f < fields; f++)
+    {
+      if (rank[f] < rank[column_field[c]])
+      {
+        size_t t = random.Pick(valid_tickets);
+
+        while (used[t][c])
+        {
+          t = random.Pick(valid_tickets);
+        }
+
+        nearby[t][c] = GapStart(f) + random.Below(10);
+        used[t][c] = true;
+      }
+    }
+  }
+
+  auto const WriteTicket = [&](vector<int64_t> const& ticket)
+  {
+    for (size_t c = 0; c < fields; c++)
+    {
+      os << ticket[c] << (c + 1 == fields ? '\n' : ',');
+    }
+  };
+
+  vector<int64_t> mine(fields);
+
+  for (int64_t& value : mine)
+  {
+    value = ValidForAll();
+  }
+
+  os << "\nyour ticket:\n";
+  WriteTicket(mine);
+
+  os << "\nnearby tickets:\n";
+
+  for (auto const& ticket : nearby)
+  {
+    WriteTicket(ticket);
+  }
+}
+
+
+} // namespace generate
+
+
+// base_size is roughly the size of the bundled input, and dimensions says how
+// size relates to the amount of input (1 for a count of lines, 2 for the side
+// of a square grid) so that inputs can be scaled by a common factor. 01w is
+// scaled as a cube, as searching it for four numbers takes the square of its
+// size in time and memory, which keeps large factors within reach.
+struct Generator
+{
+  std::string name;
+  size_t base_size;
+  unsigned dimensions;
+  std::function<void(std::ostream&, size_t, Random&)> generate;
+
+  size_t ScaledSize(double const factor) const
+  {
+    return std::max<size_t>(1, std::llround(base_size * std::pow(factor, 1.0 / dimensions)));
+  }
+};
+
+
+inline std::vector<Generator> const& Generators()
+{
+  static std::vector<Generator> const generators = {
+    {"01", 200, 1, generate::Day01},
+    {"01w", 200, 3, generate::Day01Wide},
+    {"02", 1000, 1, generate::Day02},
+    {"03", 100, 2, generate::Day03},
+    {"04", 250, 1, generate::Day04},
+    {"05", 888, 1, generate::Day05},
+    {"06", 480, 1, generate::Day06},
+    {"07", 594, 1, generate::Day07},
+    {"08", 594, 1, generate::Day08},
+    {"09", 1000, 1, generate::Day09},
+    {"10", 94, 1, generate::Day10},
+    {"11", 93, 2, generate::Day11},
+    {"12", 770, 1, generate::Day12},
+    {"13", 68, 1, generate::Day13},
+    {"14", 567, 1, generate::Day14},
+    {"15", 6, 1, generate::Day15},
+    {"16", 240, 1, generate::Day16}
+  };
+
+  return generators;
+}
+
+
+#endif // GENERATORS_INCLUDED
@@ -0,0 +1,70 @@
+#ifndef SOLVERS_INCLUDED
+#define SOLVERS_INCLUDED
+
+#include "solver.hpp"
+
+#include "01/solver.hpp"
+#include "02/solver.hpp"
+#include "03/solver.hpp"
+#include "04/solver.hpp"
+#include "05/solver.hpp"
+#include "06/solver.hpp"
+#include "07/solver.hpp"
+#include "08/solver.hpp"
+#include "09/solver.hpp"
+#include "10/solver.hpp"
+#include "11/solver.hpp"
+#include "12/solver.hpp"
+#include "13/solver.hpp"
+#include "14/solver.hpp"
+#include "15/solver.hpp"
+#include "16/solver.hpp"
+
+#include <vector>
+#include <string_view>
+
+
+// Every day with a C++ solution, along with its bundled input (relative to
+// the src directory). Day 05 is meant for a simulated CPU (see 05/README.md),
+// this is the host version it is checked against.
+inline std::vector<Solver> const& Solvers()
+{
+  static std::vector<Solver> const solvers = {
+    {"01", "01/numbers", day01::Solve},
+    {"02", "02/passwords", day02::Solve},
+    {"03", "03/trees", day03::Solve},
+    {"04", "04/passports", day04::Solve},
+    {"05", "05/seats", day05::Solve},
+    {"06", "06/answers", day06::Solve},
+    {"07", "07/rules", day07::Solve},
+    {"08", "08/program", day08::Solve},
+    {"09", "09/sequence", day09::Solve},
+    {"10", "10/adapter_ratings", day10::Solve},
+    {"11", "11/seat_map", day11::Solve},
+    {"12", "12/instructions", day12::Solve},
+    {"13", "13/busses", day13::Solve},
+    {"14", "14/program", day14::Solve},
+    {"15", "15/sequence", day15::Solve},
+    {"16", "16/tickets", day16::Solve}
+  };
+
+  return solvers;
+}
+
+
+// nullptr if there is no solver for that day
+inline Solver const* FindSolver(std::string_view const name)
+{
+  for (Solver const& solver : Solvers())
+  {
+    if (solver.name == name)
+    {
+      return &solver;
+    }
+  }
+
+  return nullptr;
+}
+
+
+#endif // SOLVERS_INCLUDED